@@ -0,0 +1,63 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "wrapper_helpers.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    INT api_success(HIDS hCam, INT value)
+    {
+        benchmark::DoNotOptimize(value);
+        return IS_SUCCESS;
+    }
+}
+
+// baseline: the raw API call the wrapper has to match on the success path
+static void BM_raw_api_call(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        if (api_success((HIDS)1, 42) != IS_SUCCESS)
+        {
+            state.SkipWithError("api call failed");
+        }
+    }
+}
+BENCHMARK(BM_raw_api_call);
+
+// wrapper overhead on the success path
+static void BM_UEYE_API_CALL_success(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        UEYE_API_CALL(api_success, {(HIDS)1, 42});
+    }
+}
+BENCHMARK(BM_UEYE_API_CALL_success);
+
+static void BM_UEYE_API_CALL_success_cleanup_handler(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        UEYE_API_CALL(api_success, {(HIDS)1, 42}, "error message", []() {});
+    }
+}
+BENCHMARK(BM_UEYE_API_CALL_success_cleanup_handler);
+
+static void BM_UEYE_API_CALL_success_std_function_cleanup_handler(benchmark::State &state)
+{
+    const std::function<void()> cleanup = []() {};
+    for (auto _ : state)
+    {
+        UEYE_API_CALL(api_success, {(HIDS)1, 42}, cleanup);
+    }
+}
+BENCHMARK(BM_UEYE_API_CALL_success_std_function_cleanup_handler);
+
@@ -0,0 +1,67 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "wrapper_types.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstring>
+
+// capture status update without new errors
+static void BM_captureErrors_update_unchanged(benchmark::State &state)
+{
+    uEyeWrapper::captureErrors errors;
+    UEYE_CAPTURE_STATUS_INFO status;
+    std::memset(&status, 0, sizeof(status));
+
+    for (auto _ : state)
+    {
+        errors.update(status, std::chrono::system_clock::now(), nullptr);
+    }
+}
+BENCHMARK(BM_captureErrors_update_unchanged);
+
+// capture status update with one error type increasing per update; reports through a callback
+static void BM_captureErrors_update_changed(benchmark::State &state)
+{
+    const std::array<UEYE_CAPTURE_STATUS, 4> statuses = {IS_CAP_STATUS_API_IMAGE_LOCKED, IS_CAP_STATUS_DRV_OUT_OF_BUFFERS, IS_CAP_STATUS_DEV_MISSED_IMAGES, IS_CAP_STATUS_DEV_TIMEOUT};
+    uEyeWrapper::captureErrors errors;
+    UEYE_CAPTURE_STATUS_INFO status;
+    std::memset(&status, 0, sizeof(status));
+
+    uint64_t reported = 0;
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        status.adwCapStatusCnt_Detail[statuses[n++ % statuses.size()]]++;
+        errors.update(status, std::chrono::system_clock::now(), [&](const uEyeWrapper::captureError &)
+                      { reported++; });
+    }
+    benchmark::DoNotOptimize(reported);
+}
+BENCHMARK(BM_captureErrors_update_changed);
+
+// consistent copy of all error statistics, e.g. for export
+static void BM_captureErrors_snapshot(benchmark::State &state)
+{
+    uEyeWrapper::captureErrors errors;
+    UEYE_CAPTURE_STATUS_INFO status;
+    std::memset(&status, 0, sizeof(status));
+    for (size_t i = 0; i < CAPTURE_ERROR_HISTORY_LENGTH; i++)
+    {
+        status.adwCapStatusCnt_Detail[IS_CAP_STATUS_API_IMAGE_LOCKED]++;
+        errors.update(status, std::chrono::system_clock::now(), nullptr);
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(errors.snapshot());
+    }
+}
+BENCHMARK(BM_captureErrors_snapshot);
@@ -0,0 +1,333 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "bench_helpers.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace uEyeWrapper;
+
+namespace
+{
+    void wait_for(const std::atomic<uint64_t> &counter, uint64_t value)
+    {
+        while (counter.load(std::memory_order_acquire) < value)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// software trigger to callback start and back, one frame in flight: driver event, dispatcher, pool and unlock
+// args: width, height, concurrency
+template <imageColorMode M, imageBitDepth D>
+static void BM_dispatch_roundtrip(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>((DWORD)state.range(0), (DWORD)state.range(1), (size_t)state.range(2));
+
+    std::atomic<uint64_t> completed = 0;
+    auto capture = camera.template getCaptureHandle<captureType::TRIGGER>(
+        [&](auto image, auto timestamp, auto seq, auto id)
+        {
+            benchmark::DoNotOptimize(image.data());
+            completed.fetch_add(1, std::memory_order_release);
+        });
+
+    uint64_t triggered = 0;
+    for (auto _ : state)
+    {
+        capture.trigger(false);
+        wait_for(completed, ++triggered);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    const auto latency = capture.dispatchLatency();
+    state.counters["wakeup_to_task_p50_us"] = latency.p50.count() / 1e3;
+    state.counters["wakeup_to_task_p99_us"] = latency.p99.count() / 1e3;
+}
+BENCHMARK_TEMPLATE(BM_dispatch_roundtrip, uEye_MONO_8)->Args({64, 64, 3})->Args({1280, 1024, 3})->UseRealTime();
+BENCHMARK_TEMPLATE(BM_dispatch_roundtrip, uEye_RGB_16)->Args({1280, 1024, 3})->UseRealTime();
+
+// software trigger to all subscribers finished: one locked buffer shared by const views, unlocked after the last subscriber
+// args: width, height, concurrency, subscribers
+template <imageColorMode M, imageBitDepth D>
+static void BM_fanout_roundtrip(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>((DWORD)state.range(0), (DWORD)state.range(1), (size_t)state.range(2));
+
+    std::atomic<uint64_t> completed = 0;
+    typename uEyeCaptureHandle<uEyeHandle<M, D>, captureType::TRIGGER>::subscriberCallbackT subscriber = [&](auto image, const frameMetadata &metadata)
+    {
+        benchmark::DoNotOptimize(image.data());
+        completed.fetch_add(1, std::memory_order_release);
+    };
+    auto capture = camera.template getCaptureHandle<captureType::TRIGGER>(nullptr, std::vector(state.range(3), subscriber));
+
+    uint64_t expected = 0;
+    for (auto _ : state)
+    {
+        capture.trigger(false);
+        wait_for(completed, expected += state.range(3));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.counters["locked_buffers_after"] = benchmark::Counter((double)camera.metrics.lockedBuffers.load());
+}
+BENCHMARK_TEMPLATE(BM_fanout_roundtrip, uEye_MONO_8)->Args({1280, 1024, 3, 1})->Args({1280, 1024, 3, 3})->UseRealTime();
+
+// software triggers collected into batches: one callback task per batch instead of per frame
+// args: width, height, concurrency, batch size
+template <imageColorMode M, imageBitDepth D>
+static void BM_batch_roundtrip(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>((DWORD)state.range(0), (DWORD)state.range(1), (size_t)state.range(2));
+
+    std::atomic<uint64_t> completed = 0;
+    std::atomic<uint64_t> batches = 0;
+    auto capture = camera.template getBatchCaptureHandle<captureType::TRIGGER>([&](auto &frames)
+                                                                               {
+                                                                                   for (auto &frame : frames)
+                                                                                   {
+                                                                                       benchmark::DoNotOptimize(frame.image().data());
+                                                                                   }
+                                                                                   batches.fetch_add(1, std::memory_order_relaxed);
+                                                                                   completed.fetch_add(frames.size(), std::memory_order_release); },
+                                                                               {(size_t)state.range(3), std::chrono::microseconds(200)});
+
+    uint64_t expected = 0;
+    for (auto _ : state)
+    {
+        // one frame event at a time, the driver coalesces events signaled before the dispatcher waits again
+        for (int64_t frame = 0; frame < state.range(3); frame++)
+        {
+            capture.trigger(false);
+            while (camera.metrics.frames.load(std::memory_order_relaxed) <= expected + frame)
+            {
+                std::this_thread::yield();
+            }
+        }
+        expected += state.range(3);
+        while (completed.load(std::memory_order_acquire) + camera.metrics.droppedFrames.load() < expected)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(3));
+    state.counters["frames_per_batch"] = benchmark::Counter((double)completed.load() / (double)std::max<uint64_t>(batches.load(), 1));
+    state.counters["dropped"] = benchmark::Counter((double)camera.metrics.droppedFrames.load());
+}
+BENCHMARK_TEMPLATE(BM_batch_roundtrip, uEye_MONO_8)->Args({1280, 1024, 5, 1})->Args({1280, 1024, 5, 4})->UseRealTime();
+
+// software trigger to a frame taken in pull mode and released: driver event, dispatcher, queue and unlock on the consumer thread
+// args: width, height, concurrency
+template <imageColorMode M, imageBitDepth D>
+static void BM_pull_roundtrip(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>((DWORD)state.range(0), (DWORD)state.range(1), (size_t)state.range(2));
+    auto capture = camera.template getCaptureHandle<captureType::TRIGGER>(nullptr);
+
+    for (auto _ : state)
+    {
+        capture.trigger(false);
+        auto frame = capture.nextFrame(std::chrono::milliseconds(1000));
+        if (!frame)
+        {
+            state.SkipWithError("no frame within 1s");
+            break;
+        }
+        benchmark::DoNotOptimize(frame->image().data());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    const auto latency = capture.dispatchLatency();
+    state.counters["wakeup_to_take_p50_us"] = latency.p50.count() / 1e3;
+    state.counters["wakeup_to_take_p99_us"] = latency.p99.count() / 1e3;
+}
+BENCHMARK_TEMPLATE(BM_pull_roundtrip, uEye_MONO_8)->Args({64, 64, 3})->Args({1280, 1024, 3})->UseRealTime();
+
+// free running capture at the requested frame rate; an iteration is one delivered callback
+// frames arriving faster than the dispatcher handles them are coalesced by the frame event or dropped for locked buffers
+// args: frame rate, concurrency
+template <imageColorMode M, imageBitDepth D>
+static void BM_dispatch_live(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>(64, 64, (size_t)state.range(1));
+    camera.setFPS((double)state.range(0));
+    const auto before = uEyeSim::stats(1);
+
+    std::atomic<uint64_t> completed = 0;
+    {
+        auto capture = camera.template getCaptureHandle<captureType::LIVE>(
+            [&](auto image, auto timestamp, auto seq, auto id)
+            {
+                benchmark::DoNotOptimize(image.data());
+                completed.fetch_add(1, std::memory_order_release);
+            });
+
+        uint64_t delivered = 0;
+        for (auto _ : state)
+        {
+            wait_for(completed, ++delivered);
+        }
+    }
+
+    const auto after = uEyeSim::stats(1);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["driver_frames"] = benchmark::Counter((double)(after.frames - before.frames));
+    state.counters["driver_dropped"] = benchmark::Counter((double)(after.dropped - before.dropped));
+    state.counters["callbacks"] = benchmark::Counter((double)completed.load());
+}
+BENCHMARK_TEMPLATE(BM_dispatch_live, uEye_MONO_8)->Args({1000, 3})->Args({10000, 3})->Args({10000, 8})->UseRealTime();
+
+// overloaded live stream: 1ms callbacks limited to 2 workers at 2000fps, 8 buffers; frames queue up behind the workers
+// reports the age of frames reaching the callback (driver timestamp, ms resolution) per 100ms window
+// args: max. frame age [us] (0: off), newest first
+template <imageColorMode M, imageBitDepth D>
+static void BM_frame_expiry_live(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>(64, 64, 8);
+    frameScheduler scheduler(2);
+    camera.useScheduler(scheduler, {1, 2});
+    camera.setFPS(2000);
+
+    latencyHistogram age;
+    std::atomic<uint64_t> completed = 0;
+    {
+        auto capture = camera.template getCaptureHandle<captureType::LIVE>(
+            [&](auto image, auto timestamp, auto seq, auto id)
+            {
+                age.record(std::chrono::system_clock::now() - timestamp);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                completed.fetch_add(1, std::memory_order_release);
+            });
+        capture.setMaxFrameAge(std::chrono::microseconds(state.range(0)));
+        capture.setNewestFirst(state.range(1));
+
+        for (auto _ : state)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    const auto summary = age.summary();
+    state.counters["age_p50_ms"] = summary.p50.count() / 1e6;
+    state.counters["age_p99_ms"] = summary.p99.count() / 1e6;
+    state.counters["callbacks"] = benchmark::Counter((double)completed.load(), benchmark::Counter::kAvgIterations);
+    state.counters["expired"] = benchmark::Counter((double)camera.metrics.expiredFrames.load(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_TEMPLATE(BM_frame_expiry_live, uEye_MONO_8)->Args({0, 0})->Args({2000, 0})->Args({0, 1})->Args({2000, 1})->Iterations(20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// LIVE <-> TRIGGER switch of a capture session, threads and pool kept; arg 0: recreate the capture handle instead
+// args: session, concurrency
+template <imageColorMode M, imageBitDepth D>
+static void BM_capture_mode_switch(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>(64, 64, (size_t)state.range(1));
+    auto callback = [](auto image, auto timestamp, auto seq, auto id)
+    { benchmark::DoNotOptimize(image.data()); };
+
+    if (state.range(0))
+    {
+        auto session = camera.template getCaptureHandle<captureType::SESSION>(callback);
+        bool live = false;
+        for (auto _ : state)
+        {
+            live = !live;
+            session.setCaptureType(live ? captureType::LIVE : captureType::TRIGGER);
+        }
+    }
+    else
+    {
+        for (auto _ : state)
+        {
+            if (state.iterations() % 2)
+            {
+                auto capture = camera.template getCaptureHandle<captureType::LIVE>(callback);
+            }
+            else
+            {
+                auto capture = camera.template getCaptureHandle<captureType::TRIGGER>(callback);
+            }
+        }
+    }
+}
+BENCHMARK_TEMPLATE(BM_capture_mode_switch, uEye_MONO_8)->Args({0, 3})->Args({1, 3})->Args({0, 8})->Args({1, 8})->UseRealTime();
+
+// live capture faster than its consumers: 3 workers at a fixed callback duration, with and without frame rate governor
+// counters: rate settled on, frames the driver dropped for lack of a free buffer
+// args: governor, callback duration [ms]
+template <imageColorMode M, imageBitDepth D>
+static void BM_fps_governor_live(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>(64, 64, 3);
+    const auto duration = std::chrono::milliseconds(state.range(1));
+    camera.setFPS(200);
+
+    for (auto _ : state)
+    {
+        auto capture = camera.template getCaptureHandle<captureType::LIVE>(
+            [&](auto image, auto timestamp, auto seq, auto id)
+            { std::this_thread::sleep_for(duration); });
+        if (state.range(0))
+        {
+            fpsGovernorPolicy policy{200};
+            policy.interval = std::chrono::milliseconds(100);
+            camera.enableFPSGovernor(policy);
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(4));
+    }
+
+    const auto governor = camera.governorState();
+    state.counters["steady_fps"] = governor ? governor->steadyFPS : 0;
+    state.counters["driver_drops"] = (double)camera.errorStats.DRV_OUT_OF_BUFFERS.count();
+    state.counters["frames"] = (double)camera.metrics.frames.load();
+    camera.disableFPSGovernor();
+}
+BENCHMARK_TEMPLATE(BM_fps_governor_live, uEye_MONO_8)->Args({0, 25})->Args({1, 25})->Iterations(1)->Unit(benchmark::kSecond)->UseRealTime();
+
+// live capture at 200 FPS, consumers stalling for 60ms every second: bursts of frames waiting for a buffer
+// counters: buffers in the sequence at the end, growths, frames the driver dropped for lack of a free buffer
+// args: buffer scaling
+template <imageColorMode M, imageBitDepth D>
+static void BM_buffer_scaling_burst(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>(64, 64, 3);
+    camera.setFPS(200);
+
+    for (auto _ : state)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto capture = camera.template getCaptureHandle<captureType::LIVE>(
+            [&](auto image, auto timestamp, auto seq, auto id)
+            {
+                if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() % 1000 < 60)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+                }
+            });
+        if (state.range(0))
+        {
+            bufferPoolPolicy policy{64 * 64 * 64};
+            policy.interval = std::chrono::milliseconds(100);
+            camera.enableBufferScaling(policy);
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(4));
+    }
+
+    const auto metrics = camera.metrics.snapshot();
+    state.counters["buffers"] = (double)metrics.sequenceBuffers;
+    state.counters["growths"] = (double)metrics.sequenceGrowths;
+    state.counters["driver_drops"] = (double)camera.errorStats.DRV_OUT_OF_BUFFERS.count();
+    state.counters["frames"] = (double)metrics.frames;
+    camera.disableBufferScaling();
+}
+BENCHMARK_TEMPLATE(BM_buffer_scaling_burst, uEye_MONO_8)->Arg(0)->Arg(1)->Iterations(1)->Unit(benchmark::kSecond)->UseRealTime();
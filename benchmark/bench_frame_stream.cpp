@@ -0,0 +1,81 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "bench_helpers.h"
+#include "frame_stream.h"
+
+// coroutine benchmarks require C++20
+#ifdef __cpp_impl_coroutine
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+using namespace uEyeWrapper;
+
+namespace
+{
+    // fire and forget coroutine
+    struct detachedTask
+    {
+        struct promise_type
+        {
+            detachedTask get_return_object() { return {}; };
+            std::suspend_never initial_suspend() noexcept { return {}; };
+            std::suspend_never final_suspend() noexcept { return {}; };
+            void return_void(){};
+            void unhandled_exception() { std::terminate(); };
+        };
+    };
+
+    template <typename StreamT>
+    detachedTask consume(StreamT &stream, std::atomic<uint64_t> &completed)
+    {
+        while (auto frame = co_await stream.next())
+        {
+            benchmark::DoNotOptimize(frame->image().data());
+            frame->release();
+            completed.fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+// software trigger to a coroutine resumed with the frame on the dispatcher thread; compare with BM_dispatch_roundtrip
+// args: width, height, concurrency
+template <imageColorMode M, imageBitDepth D>
+static void BM_frame_stream_roundtrip(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>((DWORD)state.range(0), (DWORD)state.range(1), (size_t)state.range(2));
+    std::atomic<uint64_t> completed = 0;
+    {
+        auto capture = camera.template getCaptureHandle<captureType::TRIGGER>(nullptr);
+        frameStream stream(capture);
+        consume(stream, completed);
+
+        uint64_t triggered = 0;
+        for (auto _ : state)
+        {
+            capture.trigger(false);
+            triggered++;
+            while (completed.load(std::memory_order_acquire) < triggered)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        const auto latency = capture.dispatchLatency();
+        state.counters["wakeup_to_resume_p50_us"] = latency.p50.count() / 1e3;
+        state.counters["wakeup_to_resume_p99_us"] = latency.p99.count() / 1e3;
+    } // ends the consumer
+}
+BENCHMARK_TEMPLATE(BM_frame_stream_roundtrip, uEye_MONO_8)->Args({64, 64, 3})->Args({1280, 1024, 3})->UseRealTime();
+
+#endif
@@ -0,0 +1,33 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "ueye_wrapper.h"
+#include "ueye_sim.h"
+
+#include <plog/Log.h>
+
+namespace uEyeBenchmark
+{
+    // open a camera of the simulated driver; per frame logging would dominate the measurement
+    template <uEyeWrapper::imageColorMode M, uEyeWrapper::imageBitDepth D>
+    uEyeWrapper::uEyeHandle<M, D> openSimulatedCamera(DWORD width, DWORD height, size_t concurrency)
+    {
+        uEyeWrapper::getLogger().setMaxSeverity(plog::error);
+
+        auto config = uEyeSim::defaultCamera(1);
+        config.width = width;
+        config.height = height;
+        config.color = M == uEyeWrapper::imageColorMode::RGB;
+        uEyeSim::configure({config});
+
+        uEyeWrapper::concurrency = concurrency;
+        return uEyeWrapper::openCamera<M, D>(uEyeWrapper::getCameraList().front(), nullptr, nullptr);
+    }
+}
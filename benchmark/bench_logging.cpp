@@ -0,0 +1,37 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "async_log.h"
+
+#include <benchmark/benchmark.h>
+
+// per frame log site with the message suppressed by the limiter; the cost paid on the dispatcher for most frames
+static void BM_logRateLimiter_suppressed(benchmark::State &state)
+{
+    static uEyeWrapper::logRateLimiter limiter(std::chrono::hours(1));
+    limiter.allow();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(limiter.allow());
+    }
+    state.counters["suppressed"] = (double)limiter.suppressed();
+}
+BENCHMARK(BM_logRateLimiter_suppressed)->ThreadRange(1, 4);
+
+// limiter with an interval of 0 allowing every message
+static void BM_logRateLimiter_disabled(benchmark::State &state)
+{
+    uEyeWrapper::logRateLimiter limiter(std::chrono::nanoseconds(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(limiter.allow());
+    }
+}
+BENCHMARK(BM_logRateLimiter_disabled);
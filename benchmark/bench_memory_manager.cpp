@@ -0,0 +1,51 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "bench_helpers.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+    // exposes the buffer addresses held in the protected map
+    template <typename H>
+    struct inspectableMemoryManager : uEyeWrapper::imageMemoryManager<H>
+    {
+        using uEyeWrapper::imageMemoryManager<H>::imageMemoryManager;
+
+        std::vector<char *> buffers() const
+        {
+            std::vector<char *> addresses;
+            for (auto it = this->begin(); it != this->end(); ++it)
+            {
+                addresses.push_back(it->first);
+            }
+            return addresses;
+        }
+    };
+}
+
+// buffer address to memory id lookup, done once per frame by the image dispatcher
+static void BM_imageMemoryManager_getID(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<uEye_MONO_8>(64, 64, (size_t)state.range(0));
+    inspectableMemoryManager<uEyeWrapper::uEyeHandle<uEye_MONO_8>> manager(camera);
+    manager.initialize();
+    const auto buffers = manager.buffers();
+
+    size_t n = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(manager.getID(buffers[n++ % buffers.size()]));
+    }
+
+    manager.cleanup();
+}
+BENCHMARK(BM_imageMemoryManager_getID)->Arg(3)->Arg(8)->Arg(32);
@@ -0,0 +1,42 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "bench_helpers.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace uEyeWrapper;
+
+// bring-up of a fleet of cameras taking 50ms each to initialize; an iteration opens and closes all cameras
+// args: cameras, parallelism
+static void BM_openCameras(benchmark::State &state)
+{
+    getLogger().setMaxSeverity(plog::error);
+
+    std::vector<uEyeSim::cameraConfig> configs;
+    for (DWORD id = 1; id <= (DWORD)state.range(0); id++)
+    {
+        configs.push_back(uEyeSim::defaultCamera(id));
+        configs.back().initDuration = std::chrono::milliseconds(50);
+    }
+    uEyeSim::configure(configs);
+    const auto cameras = getCameraList();
+
+    for (auto _ : state)
+    {
+        auto opened = openCameras<uEye_MONO_8>(cameras, nullptr, (size_t)state.range(1), nullptr);
+        for (const auto &result : opened)
+        {
+            if (result.error)
+            {
+                state.SkipWithError("failed to open a simulated camera");
+            }
+        }
+    }
+}
+BENCHMARK(BM_openCameras)->Args({8, 1})->Args({8, 8})->Args({40, 8})->Args({40, 40})->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "pixel_clock_planner.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace uEyeWrapper;
+
+namespace
+{
+    // sensor readout of width * height pixels plus a fixed blanking time per frame; not proportional to the clock
+    double max_fps(UINT clock, double pixels, double blanking_s)
+    {
+        return 1 / (blanking_s + pixels / (clock * 1e6));
+    }
+
+    // the frame time counter holds 2^24 clock cycles; the minimum FPS rises with the clock
+    fpsRange fps_range(UINT clock, double pixels, double blanking_s)
+    {
+        return {clock * 1e6 / (1 << 24), max_fps(clock, pixels, blanking_s)};
+    }
+}
+
+// camera round trips to find the lowest pixel clock for a requested FPS, from 5-400MHz in 1MHz steps at 30MHz
+// counters compare to stepping through all clocks above the current one, as done before the planner
+// args: requested FPS, blanking [us]
+static void BM_pixelClockPlanner_minimalBandwidth(benchmark::State &state)
+{
+    const double pixels = 2456 * 2054;
+    const double blanking = state.range(1) * 1e-6;
+    const double FPS = (double)state.range(0);
+
+    std::vector<UINT> clocks;
+    for (UINT clock = 5; clock <= 400; clock++)
+    {
+        clocks.push_back(clock);
+    }
+    const pixelClockPlanner planner(clocks, 30, fps_range(30, pixels, blanking));
+
+    pixelClockPlan plan;
+    for (auto _ : state)
+    {
+        plan = planner.plan(FPS, pixelClockObjective::minimalBandwidth, [&](UINT clock)
+                            { return fps_range(clock, pixels, blanking); });
+        benchmark::DoNotOptimize(plan);
+    }
+
+    size_t stepped = 0;
+    for (UINT clock = 31; clock <= 400 && max_fps(clock - 1, pixels, blanking) < FPS; clock++)
+    {
+        stepped++;
+    }
+    state.counters["clock"] = plan.clock;
+    state.counters["probes"] = (double)plan.probes;
+    state.counters["probes_stepping"] = (double)stepped;
+}
+BENCHMARK(BM_pixelClockPlanner_minimalBandwidth)->Args({10, 0})->Args({20, 0})->Args({20, 2000})->Args({50, 2000})->Args({100, 2000});
+
+// camera round trips to find the highest pixel clock whose minimum FPS allows the request, from 5-400MHz in 1MHz steps at 30MHz
+// the minimum FPS reaches 23.8 at 400MHz; lower requests search below the highest clock
+// args: requested FPS
+static void BM_pixelClockPlanner_minimalLatency(benchmark::State &state)
+{
+    const double pixels = 2456 * 2054;
+    const double FPS = (double)state.range(0);
+
+    std::vector<UINT> clocks;
+    for (UINT clock = 5; clock <= 400; clock++)
+    {
+        clocks.push_back(clock);
+    }
+    const pixelClockPlanner planner(clocks, 30, fps_range(30, pixels, 0));
+
+    pixelClockPlan plan;
+    for (auto _ : state)
+    {
+        plan = planner.plan(FPS, pixelClockObjective::minimalLatency, [&](UINT clock)
+                            { return fps_range(clock, pixels, 0); });
+        benchmark::DoNotOptimize(plan);
+    }
+
+    state.counters["clock"] = plan.clock;
+    state.counters["probes"] = (double)plan.probes;
+    state.counters["feasible"] = plan.feasible;
+}
+BENCHMARK(BM_pixelClockPlanner_minimalLatency)->Arg(1)->Arg(10)->Arg(30);
@@ -0,0 +1,59 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "pixel_helpers.h"
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/ImageView.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace
+{
+    template <typename PixelT>
+    struct testImage
+    {
+        testImage(int width, int height) : data((size_t)width * height * sizeof(PixelT), 0x0f),
+                                           view(data.data(), {sln::PixelLength(width), sln::PixelLength(height)}){};
+
+        std::vector<uint8_t> data;
+        sln::MutableImageView<PixelT> view;
+    };
+}
+
+// in place 12 -> 16 bit value scaling applied to every RGB 16 bit frame by the dispatcher
+template <typename PixelT>
+static void BM_rescale_12_to_16_bit(benchmark::State &state)
+{
+    testImage<PixelT> image((int)state.range(0), (int)state.range(1));
+    for (auto _ : state)
+    {
+        uEyeWrapper::rescale_12_to_16_bit(image.view);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)image.data.size());
+}
+BENCHMARK_TEMPLATE(BM_rescale_12_to_16_bit, sln::PixelRGB_16u)->Args({640, 480})->Args({1280, 1024})->Args({2456, 2054});
+BENCHMARK_TEMPLATE(BM_rescale_12_to_16_bit, sln::PixelY_16u)->Args({1280, 1024});
+
+// in place byte swap, e.g. before writing 16 bit PNG
+template <typename PixelT>
+static void BM_swap_16_bit_endianness(benchmark::State &state)
+{
+    testImage<PixelT> image((int)state.range(0), (int)state.range(1));
+    for (auto _ : state)
+    {
+        uEyeWrapper::swap_16_bit_endianness(image.view);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * (int64_t)image.data.size());
+}
+BENCHMARK_TEMPLATE(BM_swap_16_bit_endianness, sln::PixelRGB_16u)->Args({640, 480})->Args({1280, 1024})->Args({2456, 2054});
+BENCHMARK_TEMPLATE(BM_swap_16_bit_endianness, sln::PixelY_16u)->Args({1280, 1024});
@@ -0,0 +1,103 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "bench_helpers.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+using namespace uEyeWrapper;
+
+namespace
+{
+    // voluntary and involuntary context switches of the process so far
+    uint64_t context_switches()
+    {
+#ifdef __linux__
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return (uint64_t)(usage.ru_nvcsw + usage.ru_nivcsw);
+#else
+        return 0;
+#endif
+    }
+}
+
+// many cameras capturing live at 200 FPS each, with own threads per camera or on one shared reactor thread;
+// an iteration captures for 100ms; the benchmark thread sleeps meanwhile, so switches are the wrapper's and the simulated driver's
+// args: cameras, use reactor
+static void BM_reactor_live(benchmark::State &state)
+{
+    typedef uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE> captureHandleT;
+
+    getLogger().setMaxSeverity(plog::error);
+    concurrency = 2;
+
+    std::vector<uEyeSim::cameraConfig> configs;
+    for (DWORD id = 1; id <= (DWORD)state.range(0); id++)
+    {
+        configs.push_back(uEyeSim::defaultCamera(id));
+        configs.back().width = 64;
+        configs.back().height = 64;
+    }
+    uEyeSim::configure(configs);
+
+    // the reactor has to outlive the cameras
+    std::unique_ptr<eventReactor> reactor;
+    if (state.range(1))
+    {
+        reactor = std::make_unique<eventReactor>(1, 2);
+    }
+
+    auto cameras = openCameras<uEye_MONO_8>(getCameraList(), nullptr, UEYE_WRAPPER_OPEN_PARALLELISM_DEFAULT, nullptr);
+    std::atomic<uint64_t> completed = 0;
+    uint64_t switches = 0;
+    uint64_t callbacks = 0;
+    {
+        std::vector<std::unique_ptr<captureHandleT>> captures;
+        for (auto &camera : cameras)
+        {
+            if (!camera.handle)
+            {
+                state.SkipWithError("failed to open a simulated camera");
+                return;
+            }
+            if (reactor)
+            {
+                camera.handle->useReactor(*reactor);
+            }
+            camera.handle->setFPS(200);
+            captures.push_back(std::make_unique<captureHandleT>(*camera.handle, [&](auto image, auto timestamp, auto seq, auto id)
+                                                                {
+                                                                    benchmark::DoNotOptimize(image.data());
+                                                                    completed.fetch_add(1, std::memory_order_release); }));
+        }
+
+        const uint64_t switches_before = context_switches();
+        const uint64_t completed_before = completed.load();
+        for (auto _ : state)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        switches = context_switches() - switches_before;
+        callbacks = completed.load() - completed_before;
+    }
+
+    state.SetItemsProcessed((int64_t)callbacks);
+    state.counters["context_switches"] = benchmark::Counter((double)switches, benchmark::Counter::kIsRate);
+    state.counters["switches_per_frame"] = benchmark::Counter((double)switches / (double)std::max<uint64_t>(callbacks, 1));
+}
+BENCHMARK(BM_reactor_live)->Args({8, 0})->Args({8, 1})->Args({32, 0})->Args({32, 1})->Iterations(20)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,122 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "frame_scheduler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <BS_thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace uEyeWrapper;
+
+namespace
+{
+    // frame callbacks blocking for 1ms (e.g. writing to disk); camera 0 receives `busy` of them per iteration, all others one
+    std::vector<size_t> skewed_load(size_t cameras, size_t busy)
+    {
+        std::vector<size_t> load(cameras, 1);
+        load[0] = busy;
+        return load;
+    }
+
+    void blocking_callback()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// per camera pools of 3 threads (the default concurrency); the busy camera queues behind its own pool while the others idle
+// args: cameras, busy camera callbacks per iteration
+static void BM_scheduler_skewed_private_pools(benchmark::State &state)
+{
+    const auto load = skewed_load((size_t)state.range(0), (size_t)state.range(1));
+    std::vector<std::unique_ptr<BS::thread_pool>> pools;
+    for (size_t camera = 0; camera < load.size(); camera++)
+    {
+        pools.push_back(std::make_unique<BS::thread_pool>(3));
+    }
+
+    for (auto _ : state)
+    {
+        for (size_t camera = 0; camera < load.size(); camera++)
+        {
+            for (size_t i = 0; i < load[camera]; i++)
+            {
+                pools[camera]->push_task(blocking_callback);
+            }
+        }
+        for (auto &pool : pools)
+        {
+            pool->wait_for_tasks();
+        }
+    }
+}
+BENCHMARK(BM_scheduler_skewed_private_pools)->Args({8, 32})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// one scheduler with 8 workers shared by all cameras (a third of the threads above)
+// args: cameras, busy camera callbacks per iteration
+static void BM_scheduler_skewed_shared(benchmark::State &state)
+{
+    const auto load = skewed_load((size_t)state.range(0), (size_t)state.range(1));
+    frameScheduler scheduler(8);
+    std::vector<std::shared_ptr<frameScheduler::group>> groups;
+    for (size_t camera = 0; camera < load.size(); camera++)
+    {
+        groups.push_back(scheduler.addGroup({}, std::to_string(camera)));
+    }
+
+    for (auto _ : state)
+    {
+        for (size_t camera = 0; camera < load.size(); camera++)
+        {
+            for (size_t i = 0; i < load[camera]; i++)
+            {
+                scheduler.submit(groups[camera], blocking_callback);
+            }
+        }
+        for (auto &group : groups)
+        {
+            scheduler.wait(*group);
+        }
+    }
+    state.counters["steals"] = benchmark::Counter((double)scheduler.steals(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_scheduler_skewed_shared)->Args({8, 32})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// scheduling overhead: empty tasks spread round robin over cameras
+// args: cameras, workers
+static void BM_scheduler_submit(benchmark::State &state)
+{
+    frameScheduler scheduler((size_t)state.range(1));
+    std::vector<std::shared_ptr<frameScheduler::group>> groups;
+    for (int64_t camera = 0; camera < state.range(0); camera++)
+    {
+        groups.push_back(scheduler.addGroup({}, std::to_string(camera)));
+    }
+
+    std::atomic<uint64_t> executed = 0;
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        scheduler.submit(groups[next++ % groups.size()], [&]()
+                         { executed.fetch_add(1, std::memory_order_relaxed); });
+    }
+    for (auto &group : groups)
+    {
+        scheduler.wait(*group);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_scheduler_submit)->Args({8, 1})->Args({8, 4})->UseRealTime();
@@ -0,0 +1,83 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "bench_helpers.h"
+#include "trigger_timer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace uEyeWrapper;
+
+namespace
+{
+    void report(benchmark::State &state, const triggerTimer &timer)
+    {
+        const auto lateness = timer.lateness().summary();
+        const auto oversleep = timer.oversleep().summary();
+        state.counters["late_p50_us"] = lateness.p50.count() / 1e3;
+        state.counters["late_p99_us"] = lateness.p99.count() / 1e3;
+        state.counters["late_max_us"] = lateness.max.count() / 1e3;
+        state.counters["oversleep_p99_us"] = oversleep.p99.count() / 1e3;
+        state.counters["missed"] = benchmark::Counter((double)timer.missed());
+    }
+}
+
+// periodic empty task every 1ms on an unpinned timer with default scheduling (stock kernel, no privileges); one iteration: 100 periods
+// args: spin [us]; 0: clock_nanosleep only
+static void BM_trigger_timer_jitter(benchmark::State &state)
+{
+    triggerTimer timer({}, 0, std::chrono::microseconds(state.range(0)));
+    std::atomic<uint64_t> fired = 0;
+    timer.every(std::chrono::system_clock::now() + std::chrono::milliseconds(5), std::chrono::milliseconds(1), [&]()
+                { fired.fetch_add(1, std::memory_order_release); });
+
+    uint64_t expected = 0;
+    for (auto _ : state)
+    {
+        expected += 100;
+        while (fired.load(std::memory_order_acquire) < expected)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    report(state, timer);
+}
+BENCHMARK(BM_trigger_timer_jitter)->Arg(0)->Arg(100)->Iterations(20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// periodic software triggers of a simulated camera at 1kHz; lateness of is_FreezeVideo against the scheduled time
+// args: spin [us]
+template <imageColorMode M, imageBitDepth D>
+static void BM_trigger_every_live(benchmark::State &state)
+{
+    auto camera = uEyeBenchmark::openSimulatedCamera<M, D>(64, 64, 3);
+    triggerTimer timer({}, 0, std::chrono::microseconds(state.range(0)));
+
+    std::atomic<uint64_t> completed = 0;
+    {
+        auto capture = camera.template getCaptureHandle<captureType::TRIGGER>(
+            [&](auto image, auto timestamp, auto seq, auto id)
+            { completed.fetch_add(1, std::memory_order_release); });
+        capture.triggerEvery(std::chrono::system_clock::now() + std::chrono::milliseconds(5), std::chrono::milliseconds(1), timer);
+
+        uint64_t expected = 0;
+        for (auto _ : state)
+        {
+            expected += 100;
+            while (completed.load(std::memory_order_acquire) < expected)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    } // cancels the trigger
+    report(state, timer);
+}
+BENCHMARK_TEMPLATE(BM_trigger_every_live, uEye_MONO_8)->Arg(0)->Arg(100)->Iterations(10)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,857 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "ueye_sim.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// pixel clocks offered by the simulated sensor [MHz]
+#define SIM_PIXEL_CLOCK_MIN 5
+#define SIM_PIXEL_CLOCK_MAX 100
+#define SIM_PIXEL_CLOCK_INCREMENT 1
+#define SIM_PIXEL_CLOCK_DEFAULT 30
+// longest frame time [s]
+#define SIM_FRAME_TIME_MAX 10.0
+
+namespace uEyeSim
+{
+    namespace
+    {
+        struct simEvent
+        {
+            bool manual_reset;
+            bool signaled;
+            bool enabled;
+        };
+
+        struct simBuffer
+        {
+            std::unique_ptr<char[]> memory;
+            bool locked;
+            UEYEIMAGEINFO info;
+        };
+
+        struct simCamera
+        {
+            cameraConfig config;
+
+            std::mutex mutex;
+            std::condition_variable changed;
+
+            bool open = false;
+            INT last_error = IS_SUCCESS;
+
+            std::map<UINT, simEvent> events;
+
+            INT next_memory_id = 1;
+            std::map<INT, simBuffer> buffers;
+            std::vector<INT> sequence;
+            size_t next_sequence_index = 0;
+            INT last_completed = 0;
+
+            uint64_t frame_number = 0;
+            cameraStats stats = {0, 0};
+            UEYE_CAPTURE_STATUS_INFO capture_status;
+
+            INT trigger_mode = IS_SET_TRIGGER_OFF;
+            UINT pixel_clock = SIM_PIXEL_CLOCK_DEFAULT;
+            double fps = 10;
+            double exposure_ms = 100;
+
+            bool live = false;
+            std::thread live_executor;
+        };
+
+        std::vector<std::unique_ptr<simCamera>> &cameras()
+        {
+            static std::vector<std::unique_ptr<simCamera>> simulated = []()
+            {
+                std::vector<std::unique_ptr<simCamera>> initial;
+                initial.push_back(std::make_unique<simCamera>());
+                initial.back()->config = defaultCamera(1);
+                return initial;
+            }();
+            return simulated;
+        }
+
+        simCamera *get_camera(HIDS hCam)
+        {
+            auto &simulated = cameras();
+            if (hCam == 0 || hCam > simulated.size() || !simulated[hCam - 1]->open)
+            {
+                return nullptr;
+            }
+            return simulated[hCam - 1].get();
+        }
+
+        double max_fps(const simCamera &camera)
+        {
+            return camera.pixel_clock * 1e6 / ((double)camera.config.width * camera.config.height);
+        }
+
+        // requires camera.mutex
+        void signal(simCamera &camera, UINT event)
+        {
+            auto it = camera.events.find(event);
+            if (it != camera.events.end())
+            {
+                it->second.signaled = true;
+                camera.changed.notify_all();
+            }
+        }
+
+        // requires camera.mutex
+        void capture_status(simCamera &camera, UEYE_CAPTURE_STATUS status)
+        {
+            camera.capture_status.adwCapStatusCnt_Detail[status]++;
+            camera.capture_status.dwCapStatusCnt_Total++;
+            signal(camera, IS_SET_EVENT_CAPTURE_STATUS);
+        }
+
+        // deliver a frame to the next unlocked buffer of the sequence; requires camera.mutex
+        void complete_frame(simCamera &camera)
+        {
+            camera.frame_number++;
+
+            for (size_t n = 0; n < camera.sequence.size(); n++)
+            {
+                const size_t index = (camera.next_sequence_index + n) % camera.sequence.size();
+                auto &buffer = camera.buffers.at(camera.sequence[index]);
+                if (buffer.locked)
+                {
+                    continue;
+                }
+
+                const auto now = std::chrono::system_clock::now();
+                const auto now_t = std::chrono::system_clock::to_time_t(now);
+                std::tm local;
+                localtime_r(&now_t, &local);
+
+                std::memset(&buffer.info, 0, sizeof(buffer.info));
+                buffer.info.u64FrameNumber = camera.frame_number;
+                buffer.info.u64TimestampDevice = (UINT64)(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() / 100); // 0.1us ticks
+                buffer.info.TimestampSystem.wYear = (WORD)(local.tm_year + 1900);
+                buffer.info.TimestampSystem.wMonth = (WORD)(local.tm_mon + 1);
+                buffer.info.TimestampSystem.wDay = (WORD)local.tm_mday;
+                buffer.info.TimestampSystem.wHour = (WORD)local.tm_hour;
+                buffer.info.TimestampSystem.wMinute = (WORD)local.tm_min;
+                buffer.info.TimestampSystem.wSecond = (WORD)local.tm_sec;
+                buffer.info.TimestampSystem.wMilliseconds = (WORD)(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+                buffer.info.dwImageWidth = camera.config.width;
+                buffer.info.dwImageHeight = camera.config.height;
+                buffer.info.dwImageBuffers = (DWORD)camera.sequence.size();
+                buffer.info.dwImageBuffersInUse = (DWORD)std::count_if(camera.buffers.begin(), camera.buffers.end(), [](auto &b)
+                                                                       { return b.second.locked; });
+
+                // tag the image data with the frame number
+                std::memcpy(buffer.memory.get(), &camera.frame_number, sizeof(camera.frame_number));
+
+                camera.last_completed = camera.sequence[index];
+                camera.next_sequence_index = (index + 1) % camera.sequence.size();
+                camera.stats.frames++;
+                signal(camera, IS_SET_EVENT_FRAME);
+                return;
+            }
+
+            camera.stats.dropped++;
+            capture_status(camera, camera.sequence.empty() ? IS_CAP_STATUS_API_NO_DEST_MEM : IS_CAP_STATUS_DRV_OUT_OF_BUFFERS);
+        }
+
+        void stop_live(simCamera &camera)
+        {
+            {
+                std::lock_guard<std::mutex> lock(camera.mutex);
+                camera.live = false;
+                camera.changed.notify_all();
+            }
+            if (camera.live_executor.joinable())
+            {
+                camera.live_executor.join();
+            }
+        }
+
+        simBuffer *find_buffer(simCamera &camera, const char *memory)
+        {
+            for (auto &[id, buffer] : camera.buffers)
+            {
+                if (buffer.memory.get() == memory)
+                {
+                    return &buffer;
+                }
+            }
+            return nullptr;
+        }
+    }
+
+    void configure(std::vector<cameraConfig> configs)
+    {
+        auto &simulated = cameras();
+        simulated.clear();
+        for (auto &config : configs)
+        {
+            simulated.push_back(std::make_unique<simCamera>());
+            simulated.back()->config = config;
+        }
+    }
+
+    cameraConfig defaultCamera(DWORD id)
+    {
+        return {id, id, "UI-SIM-C", std::to_string(4100000000u + id), 640, 480, true, std::chrono::milliseconds(0)};
+    }
+
+    cameraStats stats(DWORD deviceId)
+    {
+        for (auto &camera : cameras())
+        {
+            if (camera->config.deviceId == deviceId)
+            {
+                std::lock_guard<std::mutex> lock(camera->mutex);
+                return camera->stats;
+            }
+        }
+        return {0, 0};
+    }
+}
+
+using namespace uEyeSim;
+
+IDSEXP is_GetNumberOfCameras(INT *pnNumCams)
+{
+    *pnNumCams = (INT)cameras().size();
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetCameraList(PUEYE_CAMERA_LIST pucl)
+{
+    auto &simulated = cameras();
+    const size_t count = std::min((size_t)pucl->dwCount, simulated.size());
+    for (size_t i = 0; i < count; i++)
+    {
+        auto &info = pucl->uci[i];
+        auto &config = simulated[i]->config;
+        std::memset(&info, 0, sizeof(info));
+        info.dwCameraID = config.cameraId;
+        info.dwDeviceID = config.deviceId;
+        info.dwInUse = simulated[i]->open;
+        std::strncpy(info.SerNo, config.serialNo.c_str(), sizeof(info.SerNo) - 1);
+        std::strncpy(info.Model, config.modelName.c_str(), sizeof(info.Model) - 1);
+        std::strncpy(info.FullModelName, config.modelName.c_str(), sizeof(info.FullModelName) - 1);
+    }
+    pucl->dwCount = (ULONG)count;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_IpConfig(INT iID, UEYE_ETH_ADDR_MAC mac, UINT nCommand, void *pParam, UINT cbSizeOfParam)
+{
+    // simulated cameras are USB cameras
+    return IS_NOT_SUPPORTED;
+}
+
+IDSEXP is_InitCamera(HIDS *phCam, void *hWnd)
+{
+    const DWORD id = *phCam & ~(DWORD)(IS_ALLOW_STARTER_FW_UPLOAD | IS_USE_DEVICE_ID);
+    const bool by_device = *phCam & IS_USE_DEVICE_ID;
+
+    auto &simulated = cameras();
+    for (size_t i = 0; i < simulated.size(); i++)
+    {
+        auto &camera = *simulated[i];
+        const bool match = id == 0 ? !camera.open : (by_device ? camera.config.deviceId : camera.config.cameraId) == id;
+        if (!match)
+        {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(camera.mutex);
+            if (camera.open)
+            {
+                return IS_CANT_OPEN_DEVICE;
+            }
+            camera.open = true;
+            camera.last_error = IS_SUCCESS;
+            std::memset(&camera.capture_status, 0, sizeof(camera.capture_status));
+        }
+        std::this_thread::sleep_for(camera.config.initDuration);
+        *phCam = (HIDS)(i + 1);
+        return IS_SUCCESS;
+    }
+    return IS_CANT_OPEN_DEVICE;
+}
+
+IDSEXP is_ExitCamera(HIDS hCam)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    stop_live(*camera);
+
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    camera->open = false;
+    camera->events.clear();
+    camera->sequence.clear();
+    camera->buffers.clear();
+    camera->changed.notify_all();
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetDuration(HIDS hCam, UINT nMode, INT *pnTime)
+{
+    *pnTime = 0;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_ResetToDefault(HIDS hCam)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    camera->pixel_clock = SIM_PIXEL_CLOCK_DEFAULT;
+    camera->fps = std::min(10.0, max_fps(*camera));
+    camera->exposure_ms = 1000 / camera->fps;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetSensorInfo(HIDS hCam, PSENSORINFO pInfo)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::memset(pInfo, 0, sizeof(SENSORINFO));
+    std::strncpy(pInfo->strSensorName, camera->config.modelName.c_str(), sizeof(pInfo->strSensorName) - 1);
+    pInfo->nColorMode = camera->config.color ? IS_COLORMODE_BAYER : IS_COLORMODE_MONOCHROME;
+    pInfo->nMaxWidth = camera->config.width;
+    pInfo->nMaxHeight = camera->config.height;
+    pInfo->bGlobShutter = TRUE;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetHdrMode(HIDS hCam, INT *Mode)
+{
+    *Mode = IS_HDR_NOT_SUPPORTED;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_EnableHdr(HIDS hCam, INT Enable)
+{
+    return IS_NOT_SUPPORTED;
+}
+
+IDSEXP is_AutoParameter(HIDS hCam, UINT nCommand, void *pParam, UINT cbSizeOfParam)
+{
+    if (!get_camera(hCam))
+    {
+        return IS_NO_SUCCESS;
+    }
+    switch (nCommand)
+    {
+    case IS_AWB_CMD_GET_SUPPORTED_TYPES:
+        *(UINT *)pParam = IS_AWB_GREYWORLD | IS_AWB_COLOR_TEMPERATURE;
+        break;
+    case IS_AWB_CMD_GET_SUPPORTED_RGB_COLOR_MODELS:
+        *(UINT *)pParam = 1;
+        break;
+    default:
+        break;
+    }
+    return IS_SUCCESS;
+}
+
+IDSEXP is_ColorTemperature(HIDS hCam, UINT nCommand, void *pParam, UINT nSizeOfParam)
+{
+    if (!get_camera(hCam))
+    {
+        return IS_NO_SUCCESS;
+    }
+    switch (nCommand)
+    {
+    case COLOR_TEMPERATURE_CMD_GET_RGB_COLOR_MODEL_DEFAULT:
+        *(UINT *)pParam = 1;
+        break;
+    case COLOR_TEMPERATURE_CMD_GET_TEMPERATURE_MIN:
+        *(UINT *)pParam = 2500;
+        break;
+    case COLOR_TEMPERATURE_CMD_GET_TEMPERATURE_MAX:
+        *(UINT *)pParam = 10000;
+        break;
+    default:
+        break;
+    }
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetFrameTimeRange(HIDS hCam, double *min, double *max, double *intervall)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    *min = 1 / max_fps(*camera);
+    *max = SIM_FRAME_TIME_MAX;
+    *intervall = 1e-6;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_PixelClock(HIDS hCam, UINT nCommand, void *pParam, UINT cbSizeOfParam)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    switch (nCommand)
+    {
+    case IS_PIXELCLOCK_CMD_GET_NUMBER:
+        *(UINT *)pParam = (SIM_PIXEL_CLOCK_MAX - SIM_PIXEL_CLOCK_MIN) / SIM_PIXEL_CLOCK_INCREMENT + 1;
+        break;
+    case IS_PIXELCLOCK_CMD_GET_LIST:
+        for (UINT n = 0; n < cbSizeOfParam / sizeof(UINT) && SIM_PIXEL_CLOCK_MIN + n * SIM_PIXEL_CLOCK_INCREMENT <= SIM_PIXEL_CLOCK_MAX; n++)
+        {
+            ((UINT *)pParam)[n] = SIM_PIXEL_CLOCK_MIN + n * SIM_PIXEL_CLOCK_INCREMENT;
+        }
+        break;
+    case IS_PIXELCLOCK_CMD_GET_RANGE:
+        ((UINT *)pParam)[0] = SIM_PIXEL_CLOCK_MIN;
+        ((UINT *)pParam)[1] = SIM_PIXEL_CLOCK_MAX;
+        ((UINT *)pParam)[2] = SIM_PIXEL_CLOCK_INCREMENT;
+        break;
+    case IS_PIXELCLOCK_CMD_GET_DEFAULT:
+        *(UINT *)pParam = SIM_PIXEL_CLOCK_DEFAULT;
+        break;
+    case IS_PIXELCLOCK_CMD_GET:
+        *(UINT *)pParam = camera->pixel_clock;
+        break;
+    case IS_PIXELCLOCK_CMD_SET:
+    {
+        const UINT clock = *(UINT *)pParam;
+        if (clock < SIM_PIXEL_CLOCK_MIN || clock > SIM_PIXEL_CLOCK_MAX)
+        {
+            camera->last_error = IS_INVALID_PARAMETER;
+            return IS_INVALID_PARAMETER;
+        }
+        camera->pixel_clock = clock;
+        // as the driver does, keep the frame rate within the new range
+        camera->fps = std::min(camera->fps, max_fps(*camera));
+        break;
+    }
+    default:
+        return IS_NOT_SUPPORTED;
+    }
+    return IS_SUCCESS;
+}
+
+IDSEXP is_SetFrameRate(HIDS hCam, double FPS, double *newFPS)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    camera->fps = std::clamp(FPS, 1 / SIM_FRAME_TIME_MAX, max_fps(*camera));
+    camera->exposure_ms = std::min(camera->exposure_ms, 1000 / camera->fps);
+    *newFPS = camera->fps;
+    camera->changed.notify_all();
+    return IS_SUCCESS;
+}
+
+IDSEXP is_Exposure(HIDS hCam, UINT nCommand, void *pParam, UINT cbSizeOfParam)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    switch (nCommand)
+    {
+    case IS_EXPOSURE_CMD_GET_EXPOSURE:
+        *(double *)pParam = camera->exposure_ms;
+        break;
+    case IS_EXPOSURE_CMD_SET_EXPOSURE:
+        camera->exposure_ms = std::clamp(*(double *)pParam, 0.01, 1000 / camera->fps);
+        *(double *)pParam = camera->exposure_ms;
+        break;
+    case IS_EXPOSURE_CMD_GET_EXPOSURE_RANGE:
+        ((double *)pParam)[0] = 0.01;
+        ((double *)pParam)[1] = 1000 / camera->fps;
+        ((double *)pParam)[2] = 0.01;
+        break;
+    default:
+        return IS_NOT_SUPPORTED;
+    }
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetError(HIDS hCam, INT *pErr, IS_CHAR **ppcErr)
+{
+    static IS_CHAR message[] = "simulated driver error";
+    auto camera = get_camera(hCam);
+    *pErr = camera ? camera->last_error : IS_NO_SUCCESS;
+    *ppcErr = message;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_Event(HIDS hCam, UINT nCommand, void *pParam, UINT nSizeOfParam)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::unique_lock<std::mutex> lock(camera->mutex);
+
+    switch (nCommand)
+    {
+    case IS_EVENT_CMD_INIT:
+        for (size_t i = 0; i < nSizeOfParam / sizeof(IS_INIT_EVENT); i++)
+        {
+            auto &init = ((IS_INIT_EVENT *)pParam)[i];
+            camera->events[init.nEvent] = {(bool)init.bManualReset, (bool)init.bInitialState, false};
+        }
+        return IS_SUCCESS;
+    case IS_EVENT_CMD_EXIT:
+    case IS_EVENT_CMD_ENABLE:
+    case IS_EVENT_CMD_DISABLE:
+    case IS_EVENT_CMD_SET:
+    case IS_EVENT_CMD_RESET:
+        for (size_t i = 0; i < nSizeOfParam / sizeof(UINT); i++)
+        {
+            auto it = camera->events.find(((UINT *)pParam)[i]);
+            if (it == camera->events.end())
+            {
+                return IS_NO_SUCCESS;
+            }
+            switch (nCommand)
+            {
+            case IS_EVENT_CMD_EXIT:
+                camera->events.erase(it);
+                break;
+            case IS_EVENT_CMD_ENABLE:
+                it->second.enabled = true;
+                break;
+            case IS_EVENT_CMD_DISABLE:
+                it->second.enabled = false;
+                break;
+            case IS_EVENT_CMD_SET:
+                it->second.signaled = true;
+                break;
+            case IS_EVENT_CMD_RESET:
+                it->second.signaled = false;
+                break;
+            }
+        }
+        camera->changed.notify_all();
+        return IS_SUCCESS;
+    case IS_EVENT_CMD_WAIT:
+    {
+        auto &wait = *(IS_WAIT_EVENTS *)pParam;
+        auto signaled = [&]() -> simEvent *
+        {
+            for (UINT i = 0; i < wait.nCount; i++)
+            {
+                auto it = camera->events.find(wait.pEvents[i]);
+                if (it != camera->events.end() && it->second.enabled && it->second.signaled)
+                {
+                    wait.nSignaled = it->first;
+                    return &it->second;
+                }
+            }
+            return nullptr;
+        };
+
+        simEvent *event = nullptr;
+        if (wait.nTimeoutMilliseconds == (UINT)INFINITE)
+        {
+            camera->changed.wait(lock, [&]()
+                                 { return (event = signaled()) != nullptr || !camera->open; });
+        }
+        else
+        {
+            camera->changed.wait_for(lock, std::chrono::milliseconds(wait.nTimeoutMilliseconds), [&]()
+                                     { return (event = signaled()) != nullptr || !camera->open; });
+        }
+
+        if (!event)
+        {
+            wait.nSignaled = 0;
+            return camera->open ? IS_TIMED_OUT : IS_NO_SUCCESS;
+        }
+        if (!event->manual_reset)
+        {
+            event->signaled = false;
+        }
+        wait.nSetCount = 1;
+        return IS_SUCCESS;
+    }
+    default:
+        return IS_NOT_SUPPORTED;
+    }
+}
+
+IDSEXP is_CaptureStatus(HIDS hCam, UINT nCommand, void *pParam, UINT nSizeOfParam)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    switch (nCommand)
+    {
+    case IS_CAPTURE_STATUS_INFO_CMD_GET:
+        std::memcpy(pParam, &camera->capture_status, std::min((size_t)nSizeOfParam, sizeof(UEYE_CAPTURE_STATUS_INFO)));
+        return IS_SUCCESS;
+    case IS_CAPTURE_STATUS_INFO_CMD_RESET:
+        std::memset(&camera->capture_status, 0, sizeof(camera->capture_status));
+        return IS_SUCCESS;
+    default:
+        return IS_NOT_SUPPORTED;
+    }
+}
+
+IDSEXP is_SetColorMode(HIDS hCam, INT Mode)
+{
+    return get_camera(hCam) ? IS_SUCCESS : IS_NO_SUCCESS;
+}
+
+IDSEXP is_SetDisplayMode(HIDS hCam, INT Mode)
+{
+    return get_camera(hCam) ? IS_SUCCESS : IS_NO_SUCCESS;
+}
+
+IDSEXP is_AllocImageMem(HIDS hCam, INT width, INT height, INT bitspixel, char **ppcImgMem, INT *pid)
+{
+    auto camera = get_camera(hCam);
+    if (!camera || width <= 0 || height <= 0 || bitspixel <= 0)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    const size_t line = ((size_t)width * bitspixel + 7) / 8;
+    auto &buffer = camera->buffers[camera->next_memory_id];
+    buffer.memory = std::unique_ptr<char[]>(new char[line * height]());
+    buffer.locked = false;
+    *ppcImgMem = buffer.memory.get();
+    *pid = camera->next_memory_id++;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_AddToSequence(HIDS hCam, char *pcImgMem, INT nID)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    auto it = camera->buffers.find(nID);
+    if (it == camera->buffers.end() || it->second.memory.get() != pcImgMem)
+    {
+        return IS_INVALID_PARAMETER;
+    }
+    camera->sequence.push_back(nID);
+    return IS_SUCCESS;
+}
+
+IDSEXP is_ClearSequence(HIDS hCam)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    camera->sequence.clear();
+    camera->next_sequence_index = 0;
+    camera->last_completed = 0;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_FreeImageMem(HIDS hCam, char *pcMem, INT id)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    auto it = camera->buffers.find(id);
+    if (it == camera->buffers.end() || it->second.memory.get() != pcMem)
+    {
+        return IS_INVALID_PARAMETER;
+    }
+    camera->sequence.erase(std::remove(camera->sequence.begin(), camera->sequence.end(), id), camera->sequence.end());
+    camera->next_sequence_index = 0;
+    if (camera->last_completed == id)
+    {
+        camera->last_completed = 0;
+    }
+    camera->buffers.erase(it);
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetActSeqBuf(HIDS hCam, INT *pnNum, char **ppcMem, char **ppcMemLast)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    if (camera->sequence.empty() || camera->last_completed == 0)
+    {
+        return IS_NO_SUCCESS;
+    }
+    *pnNum = (INT)camera->next_sequence_index + 1;
+    *ppcMem = camera->buffers.at(camera->sequence[camera->next_sequence_index]).memory.get();
+    *ppcMemLast = camera->buffers.at(camera->last_completed).memory.get();
+    return IS_SUCCESS;
+}
+
+IDSEXP is_LockSeqBuf(HIDS hCam, INT nNum, char *pcMem)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    auto buffer = find_buffer(*camera, pcMem);
+    if (!buffer)
+    {
+        return IS_INVALID_PARAMETER;
+    }
+    buffer->locked = true;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_UnlockSeqBuf(HIDS hCam, INT nNum, char *pcMem)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    auto buffer = find_buffer(*camera, pcMem);
+    if (!buffer)
+    {
+        return IS_INVALID_PARAMETER;
+    }
+    buffer->locked = false;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_GetImageInfo(HIDS hCam, INT nImageBufferID, UEYEIMAGEINFO *pImageInfo, INT nImageInfoSize)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    auto it = camera->buffers.find(nImageBufferID);
+    if (it == camera->buffers.end())
+    {
+        return IS_INVALID_PARAMETER;
+    }
+    std::memcpy(pImageInfo, &it->second.info, std::min((size_t)nImageInfoSize, sizeof(UEYEIMAGEINFO)));
+    return IS_SUCCESS;
+}
+
+IDSEXP is_FreezeVideo(HIDS hCam, INT Wait)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    complete_frame(*camera);
+    return IS_SUCCESS;
+}
+
+IDSEXP is_CaptureVideo(HIDS hCam, INT Wait)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    if (camera->live)
+    {
+        return IS_SUCCESS;
+    }
+    camera->live = true;
+    camera->live_executor = std::thread([camera]()
+                                        {
+                                            std::unique_lock<std::mutex> lock(camera->mutex);
+                                            auto next = std::chrono::steady_clock::now();
+                                            while (camera->live)
+                                            {
+                                                next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1 / camera->fps));
+                                                if (camera->changed.wait_until(lock, next, [&]()
+                                                                               { return !camera->live; }))
+                                                {
+                                                    break;
+                                                }
+                                                complete_frame(*camera);
+                                            } });
+    return IS_SUCCESS;
+}
+
+IDSEXP is_StopLiveVideo(HIDS hCam, INT Wait)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    stop_live(*camera);
+    return IS_SUCCESS;
+}
+
+IDSEXP is_SetExternalTrigger(HIDS hCam, INT nTriggerMode)
+{
+    auto camera = get_camera(hCam);
+    if (!camera)
+    {
+        return IS_NO_SUCCESS;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    if (nTriggerMode == IS_GET_TRIGGER_STATUS)
+    {
+        return camera->trigger_mode;
+    }
+    camera->trigger_mode = nTriggerMode;
+    return IS_SUCCESS;
+}
+
+IDSEXP is_ForceTrigger(HIDS hCam)
+{
+    return get_camera(hCam) ? IS_SUCCESS : IS_NO_SUCCESS;
+}
@@ -0,0 +1,48 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <ueye.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// simulated uEye driver
+// implements the subset of the uEye C API used by the wrapper in process, without cameras attached
+// frames are produced by is_FreezeVideo (immediately) or is_CaptureVideo (free run at the set frame rate)
+// and delivered through the same sequence buffers, locks, events and capture status counters as by the driver
+namespace uEyeSim
+{
+    struct cameraConfig
+    {
+        DWORD cameraId;
+        DWORD deviceId;
+        std::string modelName;
+        std::string serialNo;
+        DWORD width;
+        DWORD height;
+        bool color;
+        std::chrono::milliseconds initDuration; // is_InitCamera blocks for, like a camera booting
+    };
+
+    struct cameraStats
+    {
+        uint64_t frames;  // frames delivered to a sequence buffer
+        uint64_t dropped; // frames dropped for all sequence buffers being locked
+    };
+
+    // replaces the simulated cameras; must not be called while a camera is open
+    // defaults to a single 640x480 color camera with camera and device id 1
+    void configure(std::vector<cameraConfig>);
+    cameraConfig defaultCamera(DWORD id);
+
+    cameraStats stats(DWORD deviceId);
+}
@@ -0,0 +1,211 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+// checks of the frameGapDetector classification, driven by synthetic frame numbers and device timestamps
+// exits non-zero on the first failed check
+
+#include "frame_gap_detector.h"
+
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+using namespace uEyeWrapper;
+
+#define CHECK(condition)                                                                   \
+    if (!(condition))                                                                      \
+    {                                                                                      \
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        return false;                                                                      \
+    }
+
+namespace
+{
+    // device timestamps are in 0.1us; 1ms frame period
+    constexpr uint64_t PERIOD = 10000;
+
+    // feeds frames in dispatch order; counts the gaps reported on the way
+    struct feeder
+    {
+        frameGapDetector detector;
+        uint64_t frameNumber;
+        uint64_t timestamp;
+        uint64_t deviceMissed;
+        size_t gaps;
+
+        feeder(bool periodic) : detector(periodic, 0), frameNumber(0), timestamp(PERIOD), deviceMissed(0), gaps(0){};
+
+        // the next frame, after skipping frame numbers and with a device interval of periods
+        std::optional<frameGap> next(uint64_t skipped = 0, double periods = 1)
+        {
+            frameNumber += 1 + skipped;
+            timestamp += (uint64_t)(periods * PERIOD);
+            auto gap = detector.frame(frameNumber, timestamp, deviceMissed);
+            gaps += gap.has_value();
+            return gap;
+        }
+
+        // frames at the regular period; true if none reported a gap
+        bool regular(size_t frames, double periods = 1)
+        {
+            const size_t before = gaps;
+            for (size_t i = 0; i < frames; i++)
+            {
+                next(0, periods);
+            }
+            return gaps == before;
+        }
+    };
+
+    // no timestamp gaps while the period is learned; the first frame and the warm-up intervals report nothing
+    bool warmup()
+    {
+        feeder camera(true);
+        CHECK(!camera.next());
+        CHECK(camera.regular(FRAME_GAP_WARMUP - 2));
+        CHECK(camera.detector.period().count() == 0);
+
+        // a long interval during warm-up is a sample, not a gap
+        CHECK(!camera.next(0, 3));
+        CHECK(camera.regular(1));
+        CHECK(camera.detector.period() > std::chrono::milliseconds(1));
+        return true;
+    }
+
+    // a long device interval counts as missed frames; the capture status counter arriving later does not report them again
+    bool device_missed_by_interval()
+    {
+        feeder camera(true);
+        CHECK(camera.regular(FRAME_GAP_WARMUP + 2));
+        CHECK(camera.detector.period() == std::chrono::milliseconds(1));
+
+        auto gap = camera.next(0, 3);
+        CHECK(gap);
+        CHECK(gap->reason == frameGap::DEVICE_MISSED);
+        CHECK(gap->frames == 2);
+        CHECK(gap->frameNumber == camera.frameNumber);
+        CHECK(gap->deviceInterval == std::chrono::milliseconds(3));
+
+        // DEV_MISSED_IMAGES catches up with the frames derived from the timestamps
+        camera.deviceMissed = 2;
+        CHECK(camera.regular(3));
+
+        // one more missed frame by the counter alone
+        camera.deviceMissed = 3;
+        gap = camera.next();
+        CHECK(gap);
+        CHECK(gap->reason == frameGap::DEVICE_MISSED);
+        CHECK(gap->frames == 1);
+        CHECK(gap->deviceInterval.count() == 0);
+        return true;
+    }
+
+    // without a regular period (trigger mode) only the capture status counter reports missed frames
+    bool device_missed_by_counter()
+    {
+        feeder camera(false);
+        CHECK(camera.regular(FRAME_GAP_WARMUP + 2));
+        CHECK(!camera.next(0, 10));
+
+        camera.deviceMissed = 4;
+        auto gap = camera.next(0, 7);
+        CHECK(gap);
+        CHECK(gap->reason == frameGap::DEVICE_MISSED);
+        CHECK(gap->frames == 4);
+        CHECK(camera.regular(2));
+        return true;
+    }
+
+    // skipped frame numbers are frames the driver received; their interval is no sample of the period
+    bool driver_skipped()
+    {
+        feeder camera(true);
+        CHECK(camera.regular(FRAME_GAP_WARMUP + 2));
+        const auto period = camera.detector.period();
+
+        auto gap = camera.next(2, 3);
+        CHECK(gap);
+        CHECK(gap->reason == frameGap::DRIVER_SKIPPED);
+        CHECK(gap->frames == 2);
+        CHECK(gap->frameNumber == camera.frameNumber);
+        CHECK(gap->deviceInterval == std::chrono::milliseconds(3));
+        CHECK(camera.detector.period() == period);
+        CHECK(camera.regular(3));
+        return true;
+    }
+
+    // after resetPeriod() the period is learned again: a new frame rate is not reported as missed frames
+    bool reset_period()
+    {
+        feeder camera(true);
+        CHECK(camera.regular(FRAME_GAP_WARMUP + 2));
+
+        camera.detector.resetPeriod();
+        CHECK(camera.detector.period().count() == 0);
+        CHECK(camera.regular(FRAME_GAP_WARMUP + 2, 2));
+        CHECK(camera.detector.period() == std::chrono::milliseconds(2));
+
+        // the new period is the reference now
+        auto gap = camera.next(0, 6);
+        CHECK(gap);
+        CHECK(gap->frames == 2);
+        return true;
+    }
+
+    // restart() and sequences starting over resynchronize without a gap and learn the period again
+    bool restarted_sequences()
+    {
+        feeder camera(true);
+        CHECK(camera.regular(FRAME_GAP_WARMUP + 2));
+
+        // frame numbers going back without restart()
+        camera.frameNumber = 0;
+        CHECK(!camera.next(0, 50));
+        CHECK(camera.detector.period().count() == 0);
+        CHECK(camera.regular(FRAME_GAP_WARMUP));
+        CHECK(camera.detector.period() == std::chrono::milliseconds(1));
+
+        // capture stopped and started again; frame numbers continue with a long pause
+        camera.detector.restart(true);
+        CHECK(camera.detector.lastFrame() == 0);
+        CHECK(!camera.next(5, 1000));
+        CHECK(camera.detector.period().count() == 0);
+        CHECK(camera.regular(FRAME_GAP_WARMUP));
+        const auto skipped = camera.next(1);
+        CHECK(skipped && skipped->reason == frameGap::DRIVER_SKIPPED);
+
+        // switched to trigger mode: long intervals are no gaps anymore
+        camera.detector.restart(false);
+        CHECK(!camera.next());
+        CHECK(camera.regular(FRAME_GAP_WARMUP + 2));
+        CHECK(!camera.next(0, 10));
+        return true;
+    }
+}
+
+int main()
+{
+    const std::vector<std::pair<const char *, bool (*)()>> checks = {
+        {"warm-up", warmup},
+        {"device missed by interval", device_missed_by_interval},
+        {"device missed by counter", device_missed_by_counter},
+        {"driver skipped", driver_skipped},
+        {"reset period", reset_period},
+        {"restarted sequences", restarted_sequences},
+    };
+
+    int failed = 0;
+    for (auto &[name, check] : checks)
+    {
+        const bool passed = check();
+        std::printf("%s: %s\n", name, passed ? "passed" : "FAILED");
+        failed += !passed;
+    }
+    return failed;
+}
@@ -0,0 +1,183 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+// checks of the frameScheduler: weighted turns, concurrency cap, wait(group), stealing and failing tasks
+// exits non-zero on the first failed check
+
+#include "frame_scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace uEyeWrapper;
+
+#define CHECK(condition)                                                                   \
+    if (!(condition))                                                                      \
+    {                                                                                      \
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        return false;                                                                      \
+    }
+
+namespace
+{
+    // blocks a single worker until released, so tasks queue up behind it
+    struct gate
+    {
+        std::mutex mutex;
+        std::condition_variable opened;
+        bool open = false;
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            opened.wait(lock, [&]()
+                        { return open; });
+        }
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = true;
+            opened.notify_all();
+        }
+    };
+
+    // one worker: a group of weight 3 runs three callbacks per turn of a group of weight 1
+    bool weighted_turns()
+    {
+        frameScheduler scheduler(1);
+        auto blocker = scheduler.addGroup({1, 1}, "blocker");
+        auto heavy = scheduler.addGroup({3, 1}, "heavy");
+        auto light = scheduler.addGroup({1, 1}, "light");
+
+        gate started;
+        gate released;
+        scheduler.submit(blocker, [&]()
+                         { started.release(); released.wait(); });
+        started.wait();
+
+        std::mutex order_mutex;
+        std::vector<char> order;
+        for (int i = 0; i < 12; i++)
+        {
+            scheduler.submit(heavy, [&]()
+                             { std::lock_guard<std::mutex> lock(order_mutex); order.push_back('h'); });
+            scheduler.submit(light, [&]()
+                             { std::lock_guard<std::mutex> lock(order_mutex); order.push_back('l'); });
+        }
+        released.release();
+        scheduler.wait(*heavy);
+        scheduler.wait(*light);
+
+        CHECK(order.size() == 24);
+        size_t heavy_first = 0;
+        for (size_t i = 0; i < 8; i++)
+        {
+            heavy_first += order[i] == 'h';
+        }
+        CHECK(heavy_first == 6);
+        return true;
+    }
+
+    // no more than maxConcurrency callbacks of a group at once; wait() returns after all of them
+    bool concurrency_cap_and_wait()
+    {
+        frameScheduler scheduler(4);
+        auto capped = scheduler.addGroup({1, 2}, "capped");
+
+        std::atomic<int> running{0};
+        std::atomic<int> peak{0};
+        std::atomic<int> done{0};
+        for (int i = 0; i < 20; i++)
+        {
+            scheduler.submit(capped, [&]()
+                             {
+                                 const int now = ++running;
+                                 int seen = peak.load();
+                                 while (now > seen && !peak.compare_exchange_weak(seen, now))
+                                 {
+                                 }
+                                 std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                                 running--;
+                                 done++; });
+        }
+        scheduler.wait(*capped);
+
+        CHECK(done == 20);
+        CHECK(peak <= 2);
+        return true;
+    }
+
+    // tokens submitted from a worker land on its own deque; idle workers steal them
+    bool stealing()
+    {
+        frameScheduler scheduler(4);
+        auto spawner = scheduler.addGroup({1, 1}, "spawner");
+        auto spawned = scheduler.addGroup({1, 4}, "spawned");
+
+        std::atomic<int> done{0};
+        scheduler.submit(spawner, [&]()
+                         {
+                             for (int i = 0; i < 16; i++)
+                             {
+                                 scheduler.submit(spawned, [&]()
+                                                  { std::this_thread::sleep_for(std::chrono::milliseconds(2)); done++; });
+                             }
+                             // keep this worker busy, so the others have to steal
+                             std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+        scheduler.wait(*spawner);
+        scheduler.wait(*spawned);
+
+        CHECK(done == 16);
+        CHECK(scheduler.steals() > 0);
+        return true;
+    }
+
+    // a throwing callback, std::exception or not, neither ends its worker nor blocks wait()
+    bool failing_tasks()
+    {
+        frameScheduler scheduler(1);
+        auto failing = scheduler.addGroup({1, 1}, "failing");
+
+        std::atomic<int> done{0};
+        scheduler.submit(failing, []()
+                         { throw std::runtime_error("callback failed"); });
+        scheduler.submit(failing, []()
+                         { throw 42; });
+        scheduler.submit(failing, [&]()
+                         { done++; });
+        scheduler.wait(*failing);
+
+        CHECK(done == 1);
+        CHECK(scheduler.executed() == 3);
+        return true;
+    }
+}
+
+int main()
+{
+    const std::vector<std::pair<const char *, bool (*)()>> checks = {
+        {"weighted turns", weighted_turns},
+        {"concurrency cap and wait", concurrency_cap_and_wait},
+        {"stealing", stealing},
+        {"failing tasks", failing_tasks},
+    };
+
+    int failed = 0;
+    for (auto &[name, check] : checks)
+    {
+        const bool passed = check();
+        std::printf("%s: %s\n", name, passed ? "passed" : "FAILED");
+        failed += !passed;
+    }
+    return failed;
+}
@@ -0,0 +1,99 @@
+#include "ueye_wrapper.h"
+#include "cluster_trigger.h"
+using namespace std::chrono_literals;
+
+#include <fmt/core.h>
+
+#include <cstring>
+#include <string>
+
+// cluster wide triggers on one host: start participants in several terminals, then the coordinator
+//     uEye-cluster participant
+//     uEye-cluster coordinator [triggers] [period ms]
+// participants trigger the first camera found, if any; the coordinator prints the skew of the reported trigger times
+int main(int argc, char const *argv[])
+{
+    try
+    {
+        uEyeWrapper::getLogger().setMaxSeverity(plog::info);
+
+        if (argc > 1 && std::strcmp(argv[1], "coordinator") == 0)
+        {
+            const int triggers = argc > 2 ? std::stoi(argv[2]) : 20;
+            const auto period = std::chrono::milliseconds(argc > 3 ? std::stoi(argv[3]) : 100);
+
+            uEyeWrapper::clusterCoordinator coordinator;
+            // wait for participants to synchronize their clocks
+            std::this_thread::sleep_for(2s);
+            fmt::print("{} participants\n", coordinator.participants());
+
+            auto next = std::chrono::system_clock::now() + 100ms;
+            for (int i = 0; i < triggers; i++, next += period)
+            {
+                // lead time: the command has to reach all participants before the trigger time
+                std::this_thread::sleep_until(next - 50ms);
+                auto sequence = coordinator.triggerAt(next);
+                std::this_thread::sleep_for(20ms);
+                if (i > 0)
+                {
+                    if (auto skew = coordinator.skew(sequence - 1))
+                    {
+                        fmt::print("trigger {}: skew {}us over {} participants\n", sequence - 1, skew->first.count() / 1e3, skew->second);
+                    }
+                }
+            }
+
+            std::this_thread::sleep_for(period);
+            const auto skews = coordinator.skews().summary();
+            fmt::print("skew over {} complete triggers: p50 {}us, p99 {}us, max {}us\n",
+                       skews.count,
+                       skews.p50.count() / 1e3,
+                       skews.p99.count() / 1e3,
+                       skews.max.count() / 1e3);
+            return 0;
+        }
+
+        if (argc > 1 && std::strcmp(argv[1], "participant") == 0)
+        {
+            uEyeWrapper::triggerTimer timer;
+            uEyeWrapper::clusterParticipant participant(timer);
+
+            auto report = [&]()
+            {
+                while (true)
+                {
+                    std::this_thread::sleep_for(1s);
+                    const auto lateness = timer.lateness().summary();
+                    fmt::print("offset {}us (round trip {}us), {} triggers, timer lateness p99 {}us\n",
+                               participant.offset() ? participant.offset()->count() / 1e3 : 0.0,
+                               participant.roundTrip().count() / 1e3,
+                               participant.triggered(),
+                               lateness.p99.count() / 1e3);
+                }
+            };
+
+            // a camera group is anything triggered together; here the first camera, if connected
+            auto cameras = uEyeWrapper::getCameraList();
+            if (cameras.empty())
+            {
+                report();
+            }
+
+            auto camera = uEyeWrapper::openCamera<uEye_MONO_8>(cameras.front());
+            auto capture = camera.getCaptureHandle<uEyeWrapper::captureType::TRIGGER>(
+                [](auto image, auto timestamp, auto seq, auto id)
+                { fmt::print("image #{}\n", seq); });
+            participant.add([&]()
+                            { capture.trigger(); });
+            report();
+        }
+
+        fmt::print("usage: {} coordinator [triggers] [period ms] | participant\n", argv[0]);
+        return 1;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "FAILED: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -1,4 +1,5 @@
 #include "ueye_wrapper.h"
+#include "pixel_helpers.h"
 using namespace std::chrono_literals;
 
 #include <fmt/core.h>
@@ -40,14 +41,7 @@ int main(int argc, char const *argv[])
                     [](auto image, auto timestamp, auto seq, auto id)
                     {
                         // endian swap in place for 16bit PNG
-                        sln::for_each_pixel(image,
-                                              [](auto& px)
-                                              {
-                                                  for(size_t i = 0; i < px.nr_channels; i++)
-                                                  {
-                                                    px[i] = ((uint16_t)px[i] << 8) | ((uint16_t)px[i] >> 8);
-                                                  }
-                                              });
+                        uEyeWrapper::swap_16_bit_endianness(image);
 
                         auto dynImg = sln::to_dyn_image_view(image);
                         sln::write_image(
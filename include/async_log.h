@@ -0,0 +1,131 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <plog/Log.h>
+#include <plog/Appenders/IAppender.h>
+
+// queued log lines; rounded up to a power of two
+#define ASYNC_LOG_CAPACITY 8192
+// writer poll interval when idle; producers only wake the writer when it sleeps
+#define ASYNC_LOG_WRITER_IDLE_WAIT_MS 100
+
+namespace uEyeWrapper
+{
+    // bounded lock-free multi producer single consumer queue of formatted log lines
+    // drained to the console by a background writer thread, started on the first line
+    // producers never block: lines are dropped and counted when the queue is full
+    class asyncLogWriter
+    {
+    public:
+        asyncLogWriter(size_t capacity = ASYNC_LOG_CAPACITY);
+        ~asyncLogWriter(); // writes all queued lines
+
+        asyncLogWriter(const asyncLogWriter &) = delete;
+        asyncLogWriter &operator=(const asyncLogWriter &) = delete;
+
+        bool push(plog::Severity, plog::util::nstring &&);
+
+        // wait until all lines queued before the call are written
+        void flush();
+        uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); };
+
+    private:
+        struct slot
+        {
+            std::atomic<size_t> sequence;
+            plog::Severity severity;
+            plog::util::nstring line;
+        };
+
+        const size_t _mask;
+        std::unique_ptr<slot[]> _slots;
+        alignas(64) std::atomic<size_t> _enqueue_position;
+        alignas(64) size_t _dequeue_position; // writer only
+
+        std::atomic<uint64_t> _queued;
+        std::atomic<uint64_t> _written;
+        std::atomic<uint64_t> _dropped;
+
+        std::once_flag _started;
+        std::atomic<bool> _running;
+        std::atomic<bool> _writer_waiting;
+        std::mutex _wake_mutex;
+        std::condition_variable _wake;
+        std::thread _writer;
+
+        void _wake_writer();
+        void _write();
+    };
+
+    // plog appender formatting on the calling thread and writing asynchronously; default appender of the library
+    // usable with a user initialized logger: plog::init(plog::info, &appender)
+    template <class Formatter>
+    class asyncLogAppender : public plog::IAppender
+    {
+    public:
+        asyncLogAppender(size_t capacity = ASYNC_LOG_CAPACITY) : _writer(capacity){};
+
+        void write(const plog::Record &record) override
+        {
+            _writer.push(record.getSeverity(), Formatter::format(record));
+        };
+
+        void flush() { _writer.flush(); };
+        uint64_t dropped() const { return _writer.dropped(); };
+
+    private:
+        asyncLogWriter _writer;
+    };
+
+    // allows one message per interval and counts the suppressed ones; an interval of 0 allows all
+    // one limiter per call site and handle, e.g. for per frame messages
+    class logRateLimiter
+    {
+    public:
+        logRateLimiter(std::chrono::nanoseconds interval) : _interval(interval.count()), _next(0), _suppressed(0){};
+
+        bool allow()
+        {
+            if (_interval == 0)
+            {
+                return true;
+            }
+
+            const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            int64_t next = _next.load(std::memory_order_relaxed);
+            if (now < next || !_next.compare_exchange_strong(next, now + _interval, std::memory_order_relaxed))
+            {
+                _suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        };
+
+        // messages suppressed since the last call
+        uint64_t suppressed() { return _suppressed.exchange(0, std::memory_order_relaxed); };
+
+    private:
+        const int64_t _interval;
+        std::atomic<int64_t> _next;
+        std::atomic<uint64_t> _suppressed;
+    };
+}
+
+// PLOG_<severity> through a logRateLimiter; the severity is checked first, disabled levels do not touch the limiter
+#define PLOG_RATE_LIMITED(severity, limiter) IF_PLOG(severity) if (!(limiter).allow()) {;} else PLOG(severity)
@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// locked buffer samples per shrink evaluation interval; growth waits at least one sample period between steps
+#define BUFFER_POOL_SAMPLES 10
+
+namespace uEyeWrapper
+{
+    // sizing of a camera's image buffer sequence
+    //   grow:   out-of-buffer errors (DRV_OUT_OF_BUFFERS, API_NO_DEST_MEM) occurred; by growth times the buffers, at least one
+    //   shrink: calmIntervals without errors, locked buffers peaked below shrinkBelow times the buffers; by one buffer
+    //           while no live capture runs, between triggered frames (see imageMemoryManager::resize)
+    struct bufferPoolPolicy
+    {
+        size_t budget;         // bytes of image memory the sequence may occupy
+        size_t minBuffers = 0; // never shrunk below; 0: global concurrency
+        double growth = 0.5;
+        std::chrono::milliseconds interval{1000};
+        unsigned int calmIntervals = 30;
+        double shrinkBelow = 0.5;
+    };
+
+    // state of a camera's sequence, sampled by the scaler
+    struct bufferPoolSample
+    {
+        size_t buffers;
+        int64_t lockedBuffers;
+        uint64_t outOfBuffers; // cumulative DRV_OUT_OF_BUFFERS + API_NO_DEST_MEM
+        bool live;             // a live capture runs; the sequence can not shrink meanwhile
+    };
+
+    // grows the image buffer sequence when the driver runs out of buffers and releases buffers again after calm periods,
+    // between minBuffers and maxBuffers; runs its own thread, woken by notify() on capture status changes
+    class bufferPoolScaler
+    {
+    public:
+        typedef std::function<bufferPoolSample()> sampleT;
+        typedef std::function<size_t(size_t)> resizeT; // requested buffers -> buffers in the sequence afterwards
+
+        // name prefixes log messages
+        bufferPoolScaler(bufferPoolPolicy, size_t minBuffers, size_t maxBuffers, sampleT, resizeT, std::string name);
+        ~bufferPoolScaler();
+
+        bufferPoolScaler(const bufferPoolScaler &) = delete;
+        bufferPoolScaler &operator=(const bufferPoolScaler &) = delete;
+
+        // capture status changed; check for out-of-buffer errors now
+        void notify();
+
+    private:
+        const bufferPoolPolicy _policy;
+        const size_t _min_buffers;
+        const size_t _max_buffers;
+        const sampleT _sample;
+        const resizeT _resize;
+        const std::string _name;
+
+        std::mutex _mutex;
+        std::condition_variable _wakeup;
+        bool _stop;
+        bool _notified;
+
+        // scaler thread only
+        uint64_t _last_errors;
+        unsigned int _calm;
+        int64_t _peak_locked; // during the calm intervals
+        bool _budget_exhausted;
+        std::chrono::steady_clock::time_point _grown;
+
+        std::thread _executor;
+        void _run();
+        void _grow(const bufferPoolSample &);
+        void _evaluate(const bufferPoolSample &);
+    };
+}
@@ -0,0 +1,156 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "latency_histogram.h"
+#include "trigger_timer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CLUSTER_DEFAULT_GROUP "239.255.42.99"
+#define CLUSTER_DEFAULT_PORT 30042
+// participants send a clock sync request per interval; the offset is taken from the sample with the shortest round trip
+// of the last CLUSTER_SYNC_SAMPLES
+#define CLUSTER_SYNC_INTERVAL 200ms
+#define CLUSTER_SYNC_SAMPLES 16
+// participants not heard of for this long are not expected to report triggers anymore
+#define CLUSTER_PARTICIPANT_TIMEOUT 2s
+// trigger commands are repeated against packet loss; participants ignore repetitions
+#define CLUSTER_TRIGGER_REPEAT 3
+#define CLUSTER_POLL_INTERVAL_MS 50
+
+namespace uEyeWrapper
+{
+    // wire format of all cluster messages; fields in network byte order, times in ns since the epoch of the sender's system_clock
+    struct clusterMessage
+    {
+        enum type : uint8_t
+        {
+            SYNC_REQUEST = 1,  // participant -> coordinator: t1 = send time
+            SYNC_RESPONSE = 2, // coordinator -> participant `peer`: t1 echoed, t2 = receive time, t3 = send time
+            TRIGGER = 3,       // coordinator -> all: trigger `sequence` at t1 (coordinator clock)
+            REPORT = 4,        // participant -> coordinator: trigger `sequence` issued at t1 (coordinator clock), t2 = lateness on the timer
+        };
+
+        type kind;
+        uint64_t sender;
+        uint64_t peer;
+        uint64_t sequence;
+        int64_t t1;
+        int64_t t2;
+        int64_t t3;
+    };
+
+    // cluster wide triggers: the coordinator multicasts "trigger at T" commands, participants estimate the offset of their
+    // system clock to the coordinator's (NTP style, over the same multicast group) and fire their triggers at T on a triggerTimer
+    // all messages go to one multicast group, so any number of processes per host can take part (e.g. on loopback)
+    // the coordinator collects the issue times reported back and records the spread per trigger as skew
+    class clusterCoordinator
+    {
+    public:
+        // interface: address of the local interface to send and receive multicast on
+        clusterCoordinator(std::string group = CLUSTER_DEFAULT_GROUP, uint16_t port = CLUSTER_DEFAULT_PORT, std::string interface = "127.0.0.1");
+        ~clusterCoordinator();
+
+        clusterCoordinator(const clusterCoordinator &) = delete;
+        clusterCoordinator &operator=(const clusterCoordinator &) = delete;
+
+        // trigger all participants at the given coordinator time; leave them enough lead time to receive the command
+        // returns the trigger sequence number
+        uint64_t triggerAt(std::chrono::system_clock::time_point);
+
+        // participants heard of within CLUSTER_PARTICIPANT_TIMEOUT
+        size_t participants() const;
+        // spread of the issue times reported for a trigger so far, and the number of reports
+        std::optional<std::pair<std::chrono::nanoseconds, size_t>> skew(uint64_t sequence) const;
+        // skew of every trigger reported by all participants expected at the time of the trigger
+        const latencyHistogram &skews() const { return _skews; };
+
+    private:
+        struct triggerReports
+        {
+            size_t expected;
+            size_t received = 0;
+            int64_t earliest = 0;
+            int64_t latest = 0;
+        };
+
+        int _socket;
+        std::vector<uint8_t> _destination; // sockaddr_in of the group
+        const uint64_t _id;
+
+        mutable std::mutex _mutex;
+        uint64_t _sequence;
+        std::map<uint64_t, std::chrono::steady_clock::time_point> _participants; // id -> last seen
+        std::map<uint64_t, triggerReports> _reports;
+        latencyHistogram _skews;
+
+        std::atomic<bool> _running;
+        std::thread _receiver;
+        void _receive();
+        size_t _active_participants() const;
+    };
+
+    class clusterParticipant
+    {
+    public:
+        clusterParticipant(triggerTimer &timer = triggerTimer::global(), std::string group = CLUSTER_DEFAULT_GROUP, uint16_t port = CLUSTER_DEFAULT_PORT, std::string interface = "127.0.0.1");
+        ~clusterParticipant();
+
+        clusterParticipant(const clusterParticipant &) = delete;
+        clusterParticipant &operator=(const clusterParticipant &) = delete;
+
+        // called on the timer thread at every cluster trigger, e.g. [&]() { capture.trigger(); } per camera group
+        // returns an id for remove()
+        size_t add(std::function<void()>);
+        void remove(size_t);
+
+        // coordinator clock - local clock, and round trip of the sample it was taken from; empty until the first response
+        std::optional<std::chrono::nanoseconds> offset() const;
+        std::chrono::nanoseconds roundTrip() const;
+        uint64_t triggered() const { return _triggered.load(std::memory_order_relaxed); };
+
+    private:
+        struct syncSample
+        {
+            int64_t offset;
+            int64_t delay;
+        };
+
+        triggerTimer &_timer;
+        int _socket;
+        std::vector<uint8_t> _destination;
+        const uint64_t _id;
+
+        mutable std::mutex _mutex;
+        std::vector<std::pair<size_t, std::function<void()>>> _triggers;
+        size_t _next_trigger;
+        std::vector<syncSample> _samples; // ring of the last CLUSTER_SYNC_SAMPLES
+        size_t _next_sample;
+        std::optional<syncSample> _best;
+        uint64_t _coordinator; // sender of the last trigger; sequences restart with a new coordinator
+        uint64_t _last_sequence;
+        std::vector<size_t> _scheduled; // timer task ids, cancelled on destruction
+
+        std::atomic<uint64_t> _triggered;
+        std::atomic<bool> _running;
+        std::thread _receiver;
+        void _receive();
+        void _schedule(uint64_t sequence, int64_t coordinator_time);
+    };
+}
@@ -0,0 +1,59 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "wrapper_types.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// bump on changes of the file format or cached values; files of other versions are ignored
+#define CAMERA_CONFIG_CACHE_VERSION 1
+
+namespace uEyeWrapper
+{
+    // settings resolved by querying a camera after is_ResetToDefault; everything optional
+    struct cameraConfigCacheEntry
+    {
+        std::map<double, UINT> pixelClock;                      // requested FPS -> pixel clock [MHz] supporting it
+        std::vector<char> aesDefault;                           // IS_AES_CMD_GET_CONFIGURATION_DEFAULT (peak) result
+        std::optional<UINT> wbColorModelDefault;                // COLOR_TEMPERATURE_CMD_GET_RGB_COLOR_MODEL_DEFAULT
+        std::optional<std::tuple<UINT, UINT>> wbTemperatureRange; // {min, max} [K]
+    };
+
+    // resolved settings keyed by camera model and serial number, persisted to a text file
+    // cached values are applied directly and validated by the camera accepting them; on mismatch the caller falls back to discovery
+    class cameraConfigCache
+    {
+    public:
+        // process wide cache stored at configCachePath; disabled while the path is empty
+        static cameraConfigCache &global();
+
+        // empty entry when disabled or unknown
+        cameraConfigCacheEntry get(const uEyeCameraInfo &);
+        // modify the entry of a camera and write the file
+        void update(const uEyeCameraInfo &, const std::function<void(cameraConfigCacheEntry &)> &);
+        void clear();
+
+    private:
+        std::mutex _mutex;
+        std::string _path; // of loaded entries
+        std::map<std::tuple<std::string, std::string>, cameraConfigCacheEntry> _entries;
+
+        // with _mutex held; false when disabled
+        bool _sync_path();
+        void _load();
+        void _store() const;
+    };
+}
@@ -0,0 +1,80 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "wrapper_types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <BS_thread_pool.hpp>
+
+// idle polling rounds yielding the cpu before a reactor thread starts sleeping
+#define EVENT_REACTOR_SPIN_ROUNDS 16
+// sleep between idle polling rounds; doubles per idle round up to the maximum, which bounds the added latency
+#define EVENT_REACTOR_MIN_SLEEP 100us
+#define EVENT_REACTOR_MAX_SLEEP 1000us
+
+namespace uEyeWrapper
+{
+    // waits for uEye events of many cameras on few threads and shares one worker pool for image callbacks
+    // the uEye API signals events per camera handle only, without pollable descriptors; every reactor thread
+    // therefore polls its registrations with a zero timeout, and backs off by yielding and growing sleeps while idle
+    // has to outlive all cameras using it
+    class eventReactor
+    {
+    public:
+        eventReactor(size_t threads = 1, size_t workers = std::thread::hardware_concurrency());
+        ~eventReactor();
+
+        eventReactor(const eventReactor &) = delete;
+        eventReactor &operator=(const eventReactor &) = delete;
+
+        // the handler runs on a reactor thread for every signaled event; keep it short, queue work on pool()
+        // registrations are spread across reactor threads by count; handlers run without holding the registrations
+        size_t add(HIDS, UINT event, std::function<void()> handler);
+        // returns after a running handler finished, unless called from the handler itself; the handler will not be called afterwards
+        void remove(size_t id);
+
+        BS::thread_pool &pool() { return _pool; };
+        size_t threadCount() const { return _shards.size(); };
+
+    private:
+        struct registration
+        {
+            size_t id;
+            HIDS handle;
+            UINT event;
+            std::function<void()> handler;
+        };
+
+        struct shard
+        {
+            std::mutex mutex;
+            std::condition_variable handled;
+            std::list<registration> registrations; // stable while a handler runs unlocked
+            size_t running = 0;                    // id of the registration whose handler executes; 0: none
+            bool remove_running = false;           // removed from within its handler; erased after it returned
+            std::thread executor;
+        };
+
+        std::atomic<bool> _running;
+        std::atomic<size_t> _next_id;
+        std::vector<std::unique_ptr<shard>> _shards;
+        BS::thread_pool _pool;
+
+        void _poll(shard &);
+    };
+}
@@ -0,0 +1,101 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// load samples averaged per evaluation interval
+#define FPS_GOVERNOR_SAMPLES 10
+
+namespace uEyeWrapper
+{
+    // hysteresis of the frame rate governor; an interval is
+    //   saturated: buffer lock errors occurred, or the mean share of locked buffers reached highWater, or frames queued for a worker
+    //              on average at least one per buffer
+    //   calm:      no errors, locked share at most lowWater and no queued frames on average
+    //   otherwise: the rate is held
+    struct fpsGovernorPolicy
+    {
+        double maxFPS;       // requested rate; never exceeded
+        double minFPS = 1;   // never undercut
+        std::chrono::milliseconds interval{250};
+        double highWater = 0.75;
+        double lowWater = 0.25;
+        double decrease = 0.8;             // factor per saturated interval
+        double increase = 0.05;            // share of maxFPS added after calmIntervals
+        unsigned int calmIntervals = 8;    // calm intervals in a row before raising the rate
+        unsigned int probeIntervals = 40;  // calm intervals in a row before raising the rate beyond the last saturated one again
+        unsigned int steadyIntervals = 20; // intervals without change after which the rate counts as settled
+    };
+
+    struct fpsGovernorState
+    {
+        double FPS;       // rate set last
+        double steadyFPS; // rate held for steadyIntervals last; zero before the first time
+        uint64_t decreases;
+        uint64_t increases;
+    };
+
+    // load of a camera's capture pipeline, sampled by the governor
+    struct fpsGovernorSample
+    {
+        double lockedShare;    // locked sequence buffers / sequence buffers
+        double queuedShare;    // frames waiting for a worker / sequence buffers
+        uint64_t lockErrors;   // cumulative API_IMAGE_LOCKED + DRV_OUT_OF_BUFFERS
+    };
+
+    // lowers the frame rate deliberately when the consumers can not keep up, instead of the driver dropping frames at random
+    // multiplicative decrease on saturation, additive increase after calm periods; the rate of the last saturated interval is a
+    // ceiling for increases until probeIntervals calm intervals passed, so the rate settles just below the pipeline's capacity
+    // runs its own thread, sampling FPS_GOVERNOR_SAMPLES times per interval
+    class fpsGovernor
+    {
+    public:
+        typedef std::function<fpsGovernorSample()> sampleT;
+        typedef std::function<void(double)> applyT;
+
+        // starts at policy.maxFPS; name prefixes log messages
+        fpsGovernor(fpsGovernorPolicy, sampleT, applyT, std::string name);
+        ~fpsGovernor();
+
+        fpsGovernor(const fpsGovernor &) = delete;
+        fpsGovernor &operator=(const fpsGovernor &) = delete;
+
+        fpsGovernorState state() const;
+
+    private:
+        const fpsGovernorPolicy _policy;
+        const sampleT _sample;
+        const applyT _apply;
+        const std::string _name;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _stop_requested;
+        bool _stop;
+        fpsGovernorState _state;
+
+        // governor thread only
+        double _ceiling; // rate of the last saturated interval; maxFPS once probing is allowed
+        unsigned int _calm;
+        unsigned int _unchanged;
+        bool _cooldown; // skip the interval after a change
+        uint64_t _last_errors;
+
+        std::thread _executor;
+        void _run();
+        void _evaluate(double lockedShare, double queuedShare, uint64_t errors);
+        void _set(double FPS);
+    };
+}
@@ -0,0 +1,58 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "wrapper_types.h"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+// device timestamp intervals longer than FRAME_GAP_INTERVAL_FACTOR times the smoothed frame period count as missed frames
+// the period is learned from FRAME_GAP_WARMUP contiguous intervals first; it follows frame rate changes with FRAME_GAP_PERIOD_ALPHA
+#define FRAME_GAP_INTERVAL_FACTOR 1.5
+#define FRAME_GAP_WARMUP 8
+#define FRAME_GAP_PERIOD_ALPHA 0.1
+
+namespace uEyeWrapper
+{
+    // classifies gaps in the frames seen by an image dispatcher; single writer (the dispatcher thread)
+    //   frame number skipped:                      DRIVER_SKIPPED, the driver filled buffers the dispatcher never handled
+    //   device timestamp interval too long (LIVE): DEVICE_MISSED, the camera did not deliver the frames in between
+    //   DEV_MISSED_IMAGES increased otherwise:     DEVICE_MISSED, e.g. in trigger mode without a regular frame period
+    // the capture status counter arrives asynchronously; missed frames already derived from timestamps are not reported again
+    class frameGapDetector
+    {
+    public:
+        // periodic: frames arrive at a regular frame period (captureType::LIVE); enables the timestamp check
+        // deviceMissed: DEV_MISSED_IMAGES count at start
+        frameGapDetector(bool periodic, uint64_t deviceMissed);
+
+        // frame number and device timestamp [0.1us] of a frame in dispatch order, current DEV_MISSED_IMAGES count
+        // frame numbers going back (capture restarted) resynchronize without a gap
+        std::optional<frameGap> frame(uint64_t frameNumber, uint64_t deviceTimestamp, uint64_t deviceMissed);
+        // forget the learned frame period, e.g. after changing the frame rate; on the writer thread
+        void resetPeriod();
+        // start over after capture was stopped, without reporting the frames in between; on the writer thread
+        void restart(bool periodic);
+
+        // last frame seen; 0: none yet
+        uint64_t lastFrame() const { return _last_frame; };
+        // smoothed device timestamp interval; zero while learning
+        std::chrono::nanoseconds period() const;
+
+    private:
+        bool _periodic;
+        uint64_t _last_frame;
+        uint64_t _last_timestamp;
+        double _period;           // [0.1us]
+        size_t _intervals;        // contiguous intervals averaged into _period
+        uint64_t _device_missed;  // DEV_MISSED_IMAGES count accounted for, by the counter or by timestamps
+    };
+}
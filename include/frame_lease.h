@@ -0,0 +1,85 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "wrapper_types.h"
+#include "metrics.h"
+
+#include <utility>
+
+#include <plog/Log.h>
+
+namespace uEyeWrapper
+{
+    // exclusive use of a locked sequence buffer; unlocks the buffer on destruction or release()
+    // move-only; has to be released before the camera handle is destroyed
+    template <typename ViewT>
+    class frameLease
+    {
+    public:
+        frameLease(HIDS handle, char *memory, ViewT image, frameMetadata metadata, cameraMetrics &metrics) : _handle(handle),
+                                                                                                            _memory(memory),
+                                                                                                            _image(image),
+                                                                                                            _metadata(metadata),
+                                                                                                            _metrics(&metrics){};
+        ~frameLease() { release(); };
+
+        frameLease(const frameLease &) = delete;
+        frameLease &operator=(const frameLease &) = delete;
+
+        frameLease(frameLease &&other) noexcept : _handle(other._handle),
+                                                  _memory(std::exchange(other._memory, nullptr)),
+                                                  _image(other._image),
+                                                  _metadata(other._metadata),
+                                                  _metrics(other._metrics){};
+        frameLease &operator=(frameLease &&other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                _handle = other._handle;
+                _memory = std::exchange(other._memory, nullptr);
+                _image = other._image;
+                _metadata = other._metadata;
+                _metrics = other._metrics;
+            }
+            return *this;
+        };
+
+        // valid until release
+        ViewT &image() { return _image; };
+        const ViewT &image() const { return _image; };
+        const frameMetadata &metadata() const { return _metadata; };
+        explicit operator bool() const { return _memory != nullptr; };
+
+        // hand the buffer back to the driver early
+        void release()
+        {
+            if (!_memory)
+            {
+                return;
+            }
+
+            const INT nret = is_UnlockSeqBuf(_handle, IS_IGNORE_PARAMETER, _memory);
+            if (nret != IS_SUCCESS)
+            {
+                PLOG_WARNING << "frame lease: is_UnlockSeqBuf() of frame #" << _metadata.frameNumber << " returned with code " << nret;
+            }
+            _metrics->lockedBuffers.fetch_sub(1, std::memory_order_relaxed);
+            _memory = nullptr;
+        };
+
+    private:
+        HIDS _handle;
+        char *_memory; // nullptr once released
+        ViewT _image;
+        frameMetadata _metadata;
+        cameraMetrics *_metrics;
+    };
+}
@@ -0,0 +1,83 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace uEyeWrapper
+{
+    // share of a camera's frame callbacks on a frameScheduler
+    struct schedulingPolicy
+    {
+        unsigned int weight = 1;   // callbacks run per turn before the worker moves on to other cameras
+        size_t maxConcurrency = 0; // callbacks of the camera running at once; 0: number of workers
+    };
+
+    // worker pool shared by capture handles of many cameras; throughput scales with workers instead of per camera pools
+    // every camera submits to a group; a group holds one token per callback allowed to run concurrently (up to maxConcurrency)
+    // tokens are queued on per worker deques: workers take tokens from the front of their own deque, idle workers steal from the back of others
+    // a worker runs up to `weight` callbacks of a token's group, then requeues the token behind the other cameras' tokens
+    class frameScheduler
+    {
+    public:
+        class group;
+
+        frameScheduler(size_t workers = std::thread::hardware_concurrency());
+        ~frameScheduler(); // runs all submitted tasks
+
+        frameScheduler(const frameScheduler &) = delete;
+        frameScheduler &operator=(const frameScheduler &) = delete;
+
+        // process wide scheduler using all cores, created on first use
+        static frameScheduler &global();
+
+        std::shared_ptr<group> addGroup(schedulingPolicy, const std::string &name);
+        void submit(const std::shared_ptr<group> &, std::function<void()>);
+        // wait for all tasks of the group submitted before the call
+        void wait(group &);
+
+        size_t workerCount() const { return _workers.size(); };
+        uint64_t executed() const { return _executed.load(std::memory_order_relaxed); };
+        uint64_t steals() const { return _steals.load(std::memory_order_relaxed); };
+
+    private:
+        struct worker
+        {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<group>> tokens;
+            std::thread executor;
+        };
+
+        std::vector<std::unique_ptr<worker>> _workers;
+        std::atomic<size_t> _next_worker;
+        std::atomic<size_t> _queued_tokens;
+
+        std::atomic<bool> _running;
+        std::atomic<size_t> _sleeping;
+        std::mutex _sleep_mutex;
+        std::condition_variable _wake;
+
+        std::atomic<uint64_t> _executed;
+        std::atomic<uint64_t> _steals;
+
+        void _push_token(const std::shared_ptr<group> &);
+        std::shared_ptr<group> _pop_token(size_t worker);
+        void _run(const std::shared_ptr<group> &);
+        void _work(size_t worker);
+    };
+}
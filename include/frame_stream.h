@@ -0,0 +1,87 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+// header only: the library builds as C++17, consumers using coroutines compile this as C++20
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include "ueye_capture_handle.h"
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+
+namespace uEyeWrapper
+{
+    // resumes on the thread signaling the frame (image dispatcher or reactor thread); keep the work up to the next co_await short
+    struct inlineExecutor
+    {
+        void operator()(std::function<void()> resume) const { resume(); };
+    };
+
+    // awaitable frames of a capture handle in pull mode (constructed with a nullptr callback)
+    // suspended consumers hold no thread; they are resumed through the executor, any callable taking a std::function<void()>,
+    // e.g. [&](auto resume) { asio::post(io, resume); }
+    //     while (auto frame = co_await stream.next()) { ... } // ends when the capture handle stops
+    // one consumer per capture handle; the capture handle has to outlive a running consumer, a suspended one is resumed with the end
+    template <typename CaptureT, typename ExecutorT = inlineExecutor>
+    class frameStream
+    {
+    public:
+        typedef typename CaptureT::frameLeaseT frameLeaseT;
+
+        frameStream(CaptureT &capture, ExecutorT executor = {}) : _capture(capture), _executor(std::move(executor)){};
+
+        class awaiter
+        {
+        public:
+            awaiter(frameStream &stream) : _stream(stream), _available(true){};
+
+            bool await_ready()
+            {
+                _frame = _stream._capture.tryNextFrame();
+                return _frame.has_value();
+            };
+
+            // does not suspend if a frame arrived in the meantime or the handle stopped
+            bool await_suspend(std::coroutine_handle<> consumer)
+            {
+                return _stream._capture.notifyFrame([this, consumer](bool available)
+                                                    {
+                                                        _available = available;
+                                                        _stream._executor([consumer]()
+                                                                          { consumer.resume(); }); });
+            };
+
+            // empty when the capture handle stopped
+            std::optional<frameLeaseT> await_resume()
+            {
+                if (!_frame && _available)
+                {
+                    _frame = _stream._capture.tryNextFrame();
+                }
+                return std::move(_frame);
+            };
+
+        private:
+            frameStream &_stream;
+            bool _available;
+            std::optional<frameLeaseT> _frame;
+        };
+
+        awaiter next() { return awaiter(*this); };
+
+    private:
+        CaptureT &_capture;
+        ExecutorT _executor;
+    };
+}
+
+#endif
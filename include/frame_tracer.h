@@ -0,0 +1,106 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// spans kept per thread; older spans are overwritten
+#define FRAME_TRACER_BUFFER_SPANS 16384
+// buffers of exited threads kept until dumped; older ones are dropped when threads come and go without dumps
+#define FRAME_TRACER_MAX_EXITED_BUFFERS 32
+// spans collected for one frame on one thread before commit
+#define FRAME_TRACE_MAX_PENDING_SPANS 8
+
+namespace uEyeWrapper
+{
+    // process wide frame lifecycle tracer
+    // spans are written to per thread ring buffers and can be dumped as Chrome trace event JSON (chrome://tracing, ui.perfetto.dev)
+    // timestamps are wall clock (system_clock) to allow merging traces of a cluster; disabled by default
+    class frameTracer
+    {
+    public:
+        static void enable() { _enabled.store(true, std::memory_order_relaxed); };
+        static void disable() { _enabled.store(false, std::memory_order_relaxed); };
+        static bool enabled() { return _enabled.load(std::memory_order_relaxed); };
+
+        // ns since epoch
+        static int64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count(); };
+
+        // append a span to the calling threads buffer; begin == end records an instant event
+        static void record(const char *name, uint32_t camera, uint64_t frame, int64_t begin, int64_t end);
+
+        // Chrome trace event JSON of all buffers; consistent when dumped after disable()
+        // buffers of exited threads are released once dumped
+        static std::string dumpChromeTrace();
+        static void writeChromeTrace(const std::string &path);
+
+        // drop all recorded spans and the buffers of exited threads
+        static void clear();
+
+    private:
+        static std::atomic<bool> _enabled;
+    };
+
+    // collects the spans of one frame on one thread until the frame number is known
+    // the enabled state is sampled once on construction; when disabled every method is a single predictable branch
+    class frameTrace
+    {
+    public:
+        frameTrace() : frameTrace(frameTracer::enabled()){};
+        // continue tracing a frame on another thread with the decision taken for it on the first
+        explicit frameTrace(bool enabled) : _enabled(enabled), _pending(0){};
+
+        bool enabled() const { return _enabled; };
+        int64_t mark() const { return _enabled ? frameTracer::now() : 0; };
+
+        // span from begin to now
+        void span(const char *name, int64_t begin)
+        {
+            if (_enabled && _pending < FRAME_TRACE_MAX_PENDING_SPANS)
+            {
+                _spans[_pending++] = {name, begin, frameTracer::now()};
+            }
+        };
+        void instant(const char *name, int64_t at)
+        {
+            if (_enabled && _pending < FRAME_TRACE_MAX_PENDING_SPANS)
+            {
+                _spans[_pending++] = {name, at, at};
+            }
+        };
+
+        void commit(uint32_t camera, uint64_t frame)
+        {
+            if (_enabled)
+            {
+                for (size_t i = 0; i < _pending; i++)
+                {
+                    frameTracer::record(_spans[i].name, camera, frame, _spans[i].begin, _spans[i].end);
+                }
+                _pending = 0;
+            }
+        };
+
+    private:
+        struct pendingSpan
+        {
+            const char *name;
+            int64_t begin;
+            int64_t end;
+        };
+
+        const bool _enabled;
+        size_t _pending;
+        std::array<pendingSpan, FRAME_TRACE_MAX_PENDING_SPANS> _spans;
+    };
+}
@@ -0,0 +1,193 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace uEyeWrapper
+{
+    // percentiles of a latencyHistogram at the time of the snapshot
+    struct latencySummary
+    {
+        uint64_t count;
+        std::chrono::nanoseconds mean;
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p90;
+        std::chrono::nanoseconds p99;
+        std::chrono::nanoseconds p999;
+        std::chrono::nanoseconds max;
+    };
+
+    // lock-free log-linear (HDR style) histogram of nanosecond durations
+    // values are grouped in 16 linear sub-buckets per power of two (~6% relative precision), up to 2^45-1ns (~9.8h)
+    // record() may be called concurrently from any number of threads; snapshots are taken without stopping writers
+    class latencyHistogram
+    {
+    public:
+        static constexpr size_t sub_bucket_bits = 4;
+        static constexpr size_t sub_buckets = 1 << sub_bucket_bits;
+        static constexpr size_t max_shift = 40;
+        static constexpr size_t bucket_count = (max_shift + 2) * sub_buckets;
+
+        latencyHistogram() { reset(); };
+        latencyHistogram(const latencyHistogram &) = delete;
+        latencyHistogram &operator=(const latencyHistogram &) = delete;
+
+        void record(std::chrono::nanoseconds duration)
+        {
+            const uint64_t value = duration.count() > 0 ? (uint64_t)duration.count() : 0;
+
+            _buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+            _count.fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(value, std::memory_order_relaxed);
+
+            uint64_t max = _max.load(std::memory_order_relaxed);
+            while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+            {
+            }
+        };
+
+        void reset()
+        {
+            for (auto &bucket : _buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            _count.store(0, std::memory_order_relaxed);
+            _sum.store(0, std::memory_order_relaxed);
+            _max.store(0, std::memory_order_relaxed);
+        };
+
+        uint64_t count() const { return _count.load(std::memory_order_relaxed); };
+
+        // value at quantile q in [0, 1]; reported as the middle of the containing bucket
+        std::chrono::nanoseconds percentile(double q) const
+        {
+            std::array<uint64_t, bucket_count> counts;
+            uint64_t total = 0;
+            for (size_t i = 0; i < bucket_count; i++)
+            {
+                counts[i] = _buckets[i].load(std::memory_order_relaxed);
+                total += counts[i];
+            }
+
+            return _percentile(counts, total, q);
+        };
+
+        latencySummary summary() const
+        {
+            std::array<uint64_t, bucket_count> counts;
+            uint64_t total = 0;
+            for (size_t i = 0; i < bucket_count; i++)
+            {
+                counts[i] = _buckets[i].load(std::memory_order_relaxed);
+                total += counts[i];
+            }
+
+            return {
+                total,
+                std::chrono::nanoseconds(total ? _sum.load(std::memory_order_relaxed) / total : 0),
+                _percentile(counts, total, 0.5),
+                _percentile(counts, total, 0.9),
+                _percentile(counts, total, 0.99),
+                _percentile(counts, total, 0.999),
+                std::chrono::nanoseconds(_max.load(std::memory_order_relaxed))};
+        };
+
+        // visit non-empty buckets as (inclusive upper bound in ns, count); used for exporting
+        template <typename F>
+        void for_each_bucket(F f) const
+        {
+            for (size_t i = 0; i < bucket_count; i++)
+            {
+                const uint64_t n = _buckets[i].load(std::memory_order_relaxed);
+                if (n)
+                {
+                    f(bucket_upper_bound(i), n);
+                }
+            }
+        };
+
+        uint64_t sum() const { return _sum.load(std::memory_order_relaxed); };
+
+        static size_t bucket_index(uint64_t value)
+        {
+            if (value < sub_buckets)
+            {
+                return (size_t)value;
+            }
+
+            size_t msb = 63;
+            while (!(value >> msb))
+            {
+                msb--;
+            }
+
+            size_t shift = msb - sub_bucket_bits;
+            if (shift > max_shift)
+            {
+                return bucket_count - 1;
+            }
+
+            return (shift + 1) * sub_buckets + (size_t)((value >> shift) - sub_buckets);
+        };
+
+        static uint64_t bucket_lower_bound(size_t index)
+        {
+            if (index < sub_buckets)
+            {
+                return index;
+            }
+            const size_t shift = index / sub_buckets - 1;
+            return (uint64_t)(index % sub_buckets + sub_buckets) << shift;
+        };
+
+        static uint64_t bucket_upper_bound(size_t index)
+        {
+            if (index < sub_buckets)
+            {
+                return index;
+            }
+            const size_t shift = index / sub_buckets - 1;
+            return ((uint64_t)(index % sub_buckets + sub_buckets + 1) << shift) - 1;
+        };
+
+    private:
+        std::array<std::atomic<uint64_t>, bucket_count> _buckets;
+        std::atomic<uint64_t> _count;
+        std::atomic<uint64_t> _sum;
+        std::atomic<uint64_t> _max;
+
+        static std::chrono::nanoseconds _percentile(const std::array<uint64_t, bucket_count> &counts, uint64_t total, double q)
+        {
+            if (!total)
+            {
+                return std::chrono::nanoseconds(0);
+            }
+
+            const uint64_t rank = std::max<uint64_t>(1, (uint64_t)(q * total + 0.5));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < bucket_count; i++)
+            {
+                seen += counts[i];
+                if (seen >= rank)
+                {
+                    const uint64_t lower = bucket_lower_bound(i);
+                    return std::chrono::nanoseconds(lower + (bucket_upper_bound(i) - lower) / 2);
+                }
+            }
+
+            return std::chrono::nanoseconds(bucket_upper_bound(bucket_count - 1));
+        };
+    };
+}
@@ -0,0 +1,111 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "latency_histogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// smoothing factor of the exponentially weighted frame rate
+#define METRICS_FPS_EWMA_ALPHA 0.1
+
+namespace uEyeWrapper
+{
+    // point in time copy of cameraMetrics
+    struct metricsSnapshot
+    {
+        latencySummary deviceToWakeup;
+        latencySummary wakeupToTaskStart;
+        latencySummary callbackDuration;
+
+        int64_t queueDepth;
+        int64_t lockedBuffers;
+        int64_t sequenceBuffers;
+        int64_t sequenceBytes;
+        double fps;
+
+        uint64_t frames;
+        uint64_t callbackErrors;
+        uint64_t droppedFrames;
+        uint64_t expiredFrames;
+        uint64_t deviceMissedFrames;
+        uint64_t driverSkippedFrames;
+        uint64_t sequenceGrowths;
+        uint64_t sequenceShrinks;
+    };
+
+    // per camera performance metrics; updated by dispatcher and pool threads without locks
+    // latencies per frame:
+    //   deviceToWakeup:    driver system timestamp of the frame -> dispatcher wakeup on the frame event (ms resolution of the driver timestamp)
+    //   wakeupToTaskStart: dispatcher wakeup -> start of the callback task on a pool worker
+    //   callbackDuration:  runtime of the user callback
+    struct cameraMetrics
+    {
+        latencyHistogram deviceToWakeup;
+        latencyHistogram wakeupToTaskStart;
+        latencyHistogram callbackDuration;
+
+        std::atomic<int64_t> queueDepth{0};    // frames dispatched to the pool, callback not yet started
+        std::atomic<int64_t> lockedBuffers{0}; // sequence buffers locked by the wrapper
+        std::atomic<int64_t> sequenceBuffers{0}; // image buffers in the sequence (imageMemoryManager)
+        std::atomic<int64_t> sequenceBytes{0};
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> callbackErrors{0};
+        std::atomic<uint64_t> droppedFrames{0}; // released without reaching a consumer (full pull queue or batch buffers)
+        std::atomic<uint64_t> expiredFrames{0}; // callback skipped, frame older than the maximum age at task start
+        std::atomic<uint64_t> deviceMissedFrames{0};  // frame gaps: not received from the camera (see frameGapDetector)
+        std::atomic<uint64_t> driverSkippedFrames{0}; // frame gaps: received by the driver, never seen by the dispatcher
+        std::atomic<uint64_t> sequenceGrowths{0};     // sequence resized at runtime, see bufferPoolScaler
+        std::atomic<uint64_t> sequenceShrinks{0};
+
+        // single writer (dispatcher thread)
+        void frame(std::chrono::steady_clock::time_point wakeup)
+        {
+            const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeup.time_since_epoch()).count();
+            const int64_t last = _last_frame.exchange(now, std::memory_order_relaxed);
+
+            if (last && now > last)
+            {
+                const double instant = 1e9 / (double)(now - last);
+                const double fps = _fps.load(std::memory_order_relaxed);
+                _fps.store(fps == 0 ? instant : fps + METRICS_FPS_EWMA_ALPHA * (instant - fps), std::memory_order_relaxed);
+            }
+            frames.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        double fps() const { return _fps.load(std::memory_order_relaxed); };
+
+        metricsSnapshot snapshot() const
+        {
+            return {
+                deviceToWakeup.summary(),
+                wakeupToTaskStart.summary(),
+                callbackDuration.summary(),
+                queueDepth.load(std::memory_order_relaxed),
+                lockedBuffers.load(std::memory_order_relaxed),
+                sequenceBuffers.load(std::memory_order_relaxed),
+                sequenceBytes.load(std::memory_order_relaxed),
+                fps(),
+                frames.load(std::memory_order_relaxed),
+                callbackErrors.load(std::memory_order_relaxed),
+                droppedFrames.load(std::memory_order_relaxed),
+                expiredFrames.load(std::memory_order_relaxed),
+                deviceMissedFrames.load(std::memory_order_relaxed),
+                driverSkippedFrames.load(std::memory_order_relaxed),
+                sequenceGrowths.load(std::memory_order_relaxed),
+                sequenceShrinks.load(std::memory_order_relaxed)};
+        };
+
+    private:
+        std::atomic<int64_t> _last_frame{0};
+        std::atomic<double> _fps{0};
+    };
+}
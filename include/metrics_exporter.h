@@ -0,0 +1,55 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "wrapper_types.h"
+#include "metrics.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace uEyeWrapper
+{
+    // serves metrics of registered cameras in Prometheus text exposition format
+    // answers every HTTP GET on <address>:<port> (e.g. http://127.0.0.1:9464/metrics); binds to loopback by default
+    // cameras have to be removed before their handle is destroyed
+    class metricsExporter
+    {
+    public:
+        metricsExporter(uint16_t port, std::string address = "127.0.0.1");
+        ~metricsExporter();
+
+        metricsExporter(const metricsExporter &) = delete;
+        metricsExporter &operator=(const metricsExporter &) = delete;
+
+        // accepts uEyeHandle<M, D>
+        template <typename H>
+        void add(const H &camera_handle) { add(camera_handle.camera, camera_handle.metrics); };
+        template <typename H>
+        void remove(const H &camera_handle) { remove(camera_handle.metrics); };
+
+        void add(const uEyeCameraInfo &, const cameraMetrics &);
+        void remove(const cameraMetrics &);
+
+        // exposition text for all registered cameras
+        std::string render() const;
+
+    private:
+        mutable std::mutex _sources_mutex;
+        std::vector<std::pair<uEyeCameraInfo, const cameraMetrics *>> _sources;
+
+        int _socket;
+        std::atomic<bool> _running;
+        std::thread _server;
+        void _serve();
+    };
+}
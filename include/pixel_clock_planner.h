@@ -0,0 +1,58 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "wrapper_types.h"
+
+#include <functional>
+#include <vector>
+
+namespace uEyeWrapper
+{
+    // frame rates supported at a pixel clock; both ends rise with the clock
+    struct fpsRange
+    {
+        double min;
+        double max;
+
+        bool contains(double FPS) const { return min <= FPS && FPS <= max; };
+    };
+
+    struct pixelClockPlan
+    {
+        UINT clock;    // set on the camera when planning returns
+        fpsRange FPS;  // at clock
+        bool feasible; // clock supports the requested FPS; otherwise the clock getting closest
+        size_t probes; // camera round trips
+    };
+
+    // finds the pixel clock for a requested FPS in the list of available clocks
+    //   minimalBandwidth: lowest clock whose maximum FPS suffices; the maximum FPS is modelled as proportional to the pixel clock,
+    //                     calibrated by the current clock and every probe; probes are placed by the model and fall back to
+    //                     bisection when the model does not halve the candidates
+    //   minimalLatency:   highest clock whose minimum FPS does not exceed the request; bisected below the highest clock
+    class pixelClockPlanner
+    {
+    public:
+        // sets the pixel clock on the camera and returns the FPS range at that clock
+        typedef std::function<fpsRange(UINT)> probeT;
+
+        pixelClockPlanner(std::vector<UINT> clocks, UINT current_clock, fpsRange current_fps);
+
+        pixelClockPlan plan(double FPS, pixelClockObjective, const probeT &) const;
+
+    private:
+        std::vector<UINT> _clocks; // ascending
+        UINT _current_clock;
+        fpsRange _current_fps;
+
+        pixelClockPlan _plan_bandwidth(double FPS, const probeT &) const;
+        pixelClockPlan _plan_latency(double FPS, const probeT &) const;
+    };
+}
@@ -0,0 +1,44 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <selene/img_ops/Algorithms.hpp>
+
+#include <cstdint>
+
+namespace uEyeWrapper
+{
+    // scale 12 bit values delivered in 16 bit channels (IS_CM_RGB12_UNPACKED) to 16 bit full scale, in place
+    template <typename ImageViewT>
+    void rescale_12_to_16_bit(ImageViewT &image)
+    {
+        sln::for_each_pixel(image,
+                            [](auto &px)
+                            {
+                                for (size_t i = 0; i < px.nr_channels; i++)
+                                {
+                                    px[i] = (uint16_t)(px[i] << 4); // * 65536 / 4096
+                                }
+                            });
+    }
+
+    // swap byte order of 16 bit channels in place; e.g. for writing 16 bit PNG images
+    template <typename ImageViewT>
+    void swap_16_bit_endianness(ImageViewT &image)
+    {
+        sln::for_each_pixel(image,
+                            [](auto &px)
+                            {
+                                for (size_t i = 0; i < px.nr_channels; i++)
+                                {
+                                    px[i] = (uint16_t)(((uint16_t)px[i] << 8) | ((uint16_t)px[i] >> 8));
+                                }
+                            });
+    }
+}
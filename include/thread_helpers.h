@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// thread placement helpers; all methods return false if the setting could not be applied
+// (missing privileges for SCHED_FIFO, invalid cpu ids or unsupported platform)
+// empty cpu lists, priority 0 and empty names are no-ops reporting success
+
+// pthread_setname_np limit: 16 bytes including terminating null
+#define THREAD_NAME_MAX_LENGTH 15
+
+namespace uEyeWrapper
+{
+    inline std::thread::native_handle_type current_thread_native_handle()
+    {
+#ifdef __linux__
+        return pthread_self();
+#else
+        return std::thread::native_handle_type();
+#endif
+    }
+
+    inline bool set_thread_affinity(std::thread::native_handle_type thread, const std::vector<int> &cpus)
+    {
+        if (cpus.empty())
+        {
+            return true;
+        }
+#ifdef __linux__
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (auto cpu : cpus)
+        {
+            if (cpu < 0 || cpu >= CPU_SETSIZE)
+            {
+                return false;
+            }
+            CPU_SET(cpu, &cpuset);
+        }
+
+        return pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset) == 0;
+#else
+        return false;
+#endif
+    }
+
+    // SCHED_FIFO with given priority (1-99); requires CAP_SYS_NICE or a matching RLIMIT_RTPRIO
+    inline bool set_thread_fifo_priority(std::thread::native_handle_type thread, int priority)
+    {
+        if (priority == 0)
+        {
+            return true;
+        }
+#ifdef __linux__
+        sched_param param;
+        param.sched_priority = priority;
+
+        return pthread_setschedparam(thread, SCHED_FIFO, &param) == 0;
+#else
+        return false;
+#endif
+    }
+
+    // names are truncated to THREAD_NAME_MAX_LENGTH characters
+    inline bool set_thread_name(std::thread::native_handle_type thread, const std::string &name)
+    {
+        if (name.empty())
+        {
+            return true;
+        }
+#ifdef __linux__
+        return pthread_setname_np(thread, name.substr(0, THREAD_NAME_MAX_LENGTH).c_str()) == 0;
+#else
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#pragma once
+
+#include "latency_histogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// sleep precision: wait on a condition variable until TRIGGER_TIMER_COARSE_MARGIN before the target, then clock_nanosleep
+// until the spin duration (default TRIGGER_TIMER_SPIN_US) before the target and busy wait for the rest
+// tasks added with a target inside the coarse margin of the next target are picked up after it fired
+#define TRIGGER_TIMER_COARSE_MARGIN 2ms
+#define TRIGGER_TIMER_SPIN_US 100
+
+namespace uEyeWrapper
+{
+    // fires tasks at absolute wall clock times (system_clock, i.e. CLOCK_REALTIME; the clock synchronized across hosts)
+    // one thread for all tasks, optionally pinned and with SCHED_FIFO priority; keep the tasks short (e.g. is_FreezeVideo)
+    // tasks due at the same time run one after another, in the order they were added
+    class triggerTimer
+    {
+    public:
+        typedef std::chrono::system_clock clock;
+
+        // priority 0: default scheduling; spin: busy wait before each target, trading cpu time for precision
+        triggerTimer(std::vector<int> cpus = {}, int priority = 0, std::chrono::nanoseconds spin = std::chrono::microseconds(TRIGGER_TIMER_SPIN_US));
+        ~triggerTimer(); // pending tasks are discarded
+
+        triggerTimer(const triggerTimer &) = delete;
+        triggerTimer &operator=(const triggerTimer &) = delete;
+
+        // process wide timer with default scheduling, created on first use
+        static triggerTimer &global();
+
+        // returns an id for cancel(); ids are unique across timers
+        size_t at(clock::time_point, std::function<void()>);
+        // first at `first`, then every period from there without drift; periods already passed are skipped (missed())
+        size_t every(clock::time_point first, std::chrono::nanoseconds period, std::function<void()>);
+        // returns after a running invocation of the task finished, unless called from the task itself
+        void cancel(size_t);
+
+        // target time -> task start
+        const latencyHistogram &lateness() const { return _lateness; };
+        // clock_nanosleep overshooting the start of the spin; at the spin duration the spin no longer covers the wakeup latency
+        const latencyHistogram &oversleep() const { return _oversleep; };
+        uint64_t fired() const { return _fired.load(std::memory_order_relaxed); };
+        uint64_t missed() const { return _missed.load(std::memory_order_relaxed); };
+
+    private:
+        struct task
+        {
+            size_t id;
+            std::chrono::nanoseconds period; // zero: once
+            std::function<void()> run;
+        };
+
+        const std::chrono::nanoseconds _spin;
+
+        std::mutex _mutex;
+        std::condition_variable _changed;
+        std::multimap<clock::time_point, task> _tasks;
+        size_t _running_task; // id of the task currently executing; 0: none
+        bool _cancel_running;
+        bool _stop;
+        std::thread _executor;
+
+        latencyHistogram _lateness;
+        latencyHistogram _oversleep;
+        std::atomic<uint64_t> _fired;
+        std::atomic<uint64_t> _missed;
+
+        size_t _add(clock::time_point, std::chrono::nanoseconds, std::function<void()>);
+        void _sleep_until(clock::time_point);
+        void _run();
+    };
+}
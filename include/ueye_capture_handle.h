@@ -2,6 +2,13 @@
 
 #include "wrapper_helpers.h"
 #include "wrapper_types.h"
+#include "metrics.h"
+#include "frame_tracer.h"
+#include "pixel_helpers.h"
+#include "async_log.h"
+#include "frame_lease.h"
+#include "trigger_timer.h"
+#include "frame_gap_detector.h"
 namespace uEyeWrapper
 {
     template <typename H, captureType C>
@@ -22,6 +29,16 @@ namespace uEyeWrapper
 #include <functional>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <optional>
+#include <mutex>
+#include <condition_variable>
+
+// poll interval waiting for running callbacks on a shared reactor pool to finish
+#define CAPTURE_CALLBACK_DRAIN_WAIT 1ms
 
 namespace uEyeWrapper
 {
@@ -34,26 +51,163 @@ namespace uEyeWrapper
         // image, timestamp, monotonic sequence counter, id
         // typedef std::function<void(constTypedImageViewT, std::chrono::time_point<std::chrono::system_clock>, size_t, size_t)> imageCallbackT;
         typedef std::function<void(typedImageViewT, std::chrono::time_point<std::chrono::system_clock>, size_t, size_t)> imageCallbackT;
+        typedef frameLease<typedImageViewT> frameLeaseT;
+        // read only consumer of every frame; runs in parallel to other subscribers
+        typedef std::function<void(constTypedImageViewT, const frameMetadata &)> subscriberCallbackT;
+        // frames of one batch in capture order; the leases are released after the callback returned, unless released earlier
+        typedef std::function<void(std::vector<frameLeaseT> &)> batchCallbackT;
 
         uEyeCaptureHandle() = delete;
-        uEyeCaptureHandle(const H &, imageCallbackT);
+        // the image callback owns the image: it may modify it in place and runs before the subscribers
+        // without image callback and subscribers, the handle works in pull mode
+        uEyeCaptureHandle(const H &, imageCallbackT, std::vector<subscriberCallbackT> = {});
+        // batch mode: one callback task per batch of frames, see batchPolicy
+        // frames arriving while all but one sequence buffer are locked are dropped instead of starving the driver
+        uEyeCaptureHandle(const H &, batchCallbackT, batchPolicy);
         ~uEyeCaptureHandle();
 
-        // disable for captureType::LIVE
+        // disable for captureType::LIVE; captureType::SESSION throws in LIVE mode
         template <typename enable_SFINAE = void>
-        auto trigger(bool = false) -> std::enable_if_t<C == captureType::TRIGGER, enable_SFINAE>;
+        auto trigger(bool = false) -> std::enable_if_t<C != captureType::LIVE, enable_SFINAE>;
         // void trigger();
+        // software trigger at an absolute time (e.g. agreed across hosts) or periodically from there, issued by a triggerTimer
+        // returns an id for cancelTrigger(); pending triggers are cancelled when the capture handle is destroyed
+        template <typename enable_SFINAE = size_t>
+        auto triggerAt(std::chrono::system_clock::time_point, triggerTimer & = triggerTimer::global()) -> std::enable_if_t<C != captureType::LIVE, enable_SFINAE>;
+        template <typename enable_SFINAE = size_t>
+        auto triggerEvery(std::chrono::system_clock::time_point first, std::chrono::nanoseconds period, triggerTimer & = triggerTimer::global()) -> std::enable_if_t<C != captureType::LIVE, enable_SFINAE>;
+        void cancelTrigger(size_t);
+
+        // stop capturing, keeping dispatcher, pool and buffers; frames dispatched before are still delivered
+        // scheduled triggers are skipped while paused, trigger() throws
+        void pause();
+        // capture again in the current capture type
+        void resume();
+        bool paused() const;
+        // captureType::SESSION: switch between TRIGGER and LIVE without tearing down the handle; keeps a pause
+        template <typename enable_SFINAE = void>
+        auto setCaptureType(captureType) -> std::enable_if_t<C == captureType::SESSION, enable_SFINAE>;
+        // capture type in effect: TRIGGER or LIVE
+        captureType mode() const;
+
+        // pull mode, if constructed with an empty image callback: frames are queued with their buffer locked until taken
+        // at most one frame less than sequence buffers is queued, so the driver keeps a free buffer; the oldest one is dropped for a new frame
+        std::optional<frameLeaseT> nextFrame(std::chrono::milliseconds timeout);
+        std::optional<frameLeaseT> tryNextFrame();
+        // pull mode, for event loops and coroutines (see frameStream): registers ready to be called once, with true when a frame
+        // is queued or false when the handle stops; called on the dispatching thread, one registration at a time
+        // returns false without registering if a frame is queued already or the handle stopped
+        bool notifyFrame(std::function<void(bool)> ready);
+
+        // push mode: add a subscriber for following frames; the buffer is unlocked after the last subscriber returned
+        size_t subscribe(subscriberCallbackT);
+        // frames already dispatched may still reach the subscriber
+        void unsubscribe(size_t);
+
+        // push mode: frames whose callback task starts later than maxAge after the frame event are unlocked and skipped
+        // (metrics.expiredFrames); zero disables expiry
+        void setMaxFrameAge(std::chrono::microseconds maxAge);
+        // push mode: idle workers take the newest queued frame first instead of the oldest
+        void setNewestFirst(bool);
+
+        // called for every gap in the delivered frames (see frameGap), on the dispatcher or, for expired frames, a pool thread
+        // gaps are counted in the metrics with or without callback
+        void onFrameGap(std::function<void(const frameGap &)>);
+
+        // latency from the dispatcher waking up on a frame event to the start of the callback task on the pool
+        latencySummary dispatchLatency() const;
+        // metrics of the camera this handle captures from
+        const cameraMetrics &metrics;
 
     private:
         imageCallbackT imageCallback;
+        const bool _pull;
+
+        // batch mode; the flusher delivers incomplete batches after maxWait
+        batchCallbackT _batch_callback;
+        const batchPolicy _batch_policy;
+        std::mutex _batch_mutex;
+        std::condition_variable _batch_pending;
+        std::vector<frameLeaseT> _batch;
+        std::chrono::steady_clock::time_point _batch_wakeup; // of the first frame in the batch
+        uint64_t _batch_generation; // incremented per delivered batch
+        bool _batch_closed;
+        std::thread _batch_flusher;
+        void _batch_frame(frameLeaseT &&, std::chrono::steady_clock::time_point);
+        void _submit_batch(std::vector<frameLeaseT> &&, std::chrono::steady_clock::time_point);
+        void _SPAWN_batch_flusher();
+        void _start();
+
+        typedef std::vector<std::pair<size_t, subscriberCallbackT>> subscriberListT;
+        std::mutex _subscribers_mutex;
+        std::shared_ptr<const subscriberListT> _subscribers; // copied on change; nullptr: none
+        size_t _next_subscriber;
+        std::shared_ptr<const subscriberListT> _subscribers_snapshot();
         // select implementation based on capture type (dynamic selection; is value not typename)
         void _start_capture();
+        // runtime capture type (C, or the current one of a session) and pause state; changed under _capture_mutex
+        std::mutex _capture_mutex;
+        std::atomic<captureType> _mode;
+        std::atomic<bool> _paused;
+        std::atomic<bool> _live_active; // registered as live capture with the camera handle, which then hands captureSettings to the dispatcher
+        uint64_t _frame_settings_generation; // of the last frame; dispatcher thread only
+        std::atomic<bool> _capturing;        // live capture registered with the memory manager, which does not shrink the sequence meanwhile
+        void _write_settings(const captureSettings &);
 
         std::thread _image_dispatcher_executor;
         void _SPAWN_image_dispatcher();
+        void _handle_frame_event();
         void _stop_threads();
 
-        BS::thread_pool _pool;
+        // own pool; nullptr when the camera uses an event reactor or a scheduler
+        std::unique_ptr<BS::thread_pool> _pool;
+        // own or the reactor's pool; nullptr when the camera uses a scheduler
+        BS::thread_pool *_executor;
+        std::shared_ptr<frameScheduler::group> _scheduler_group;
+        void _submit(std::function<void()> &&);
+        // frame tasks, ordered by _newest_first
+        void _submit_frame(std::function<void()> &&);
+        std::atomic<std::chrono::microseconds> _max_frame_age;
+        std::atomic<bool> _newest_first;
+        std::mutex _frame_tasks_mutex;
+        std::vector<std::function<void()>> _frame_tasks; // newest first: taken from the back by the executor tasks
+        void _wait_for_callbacks();
+        // callbacks of this handle queued on the reactor's pool; the shared pool can not be waited for per handle
+        std::atomic<size_t> _callbacks_in_flight;
+        size_t _reactor_registration;
+        void _apply_thread_placement();
+
+        // pull mode queue
+        struct queuedFrame
+        {
+            frameLeaseT lease;
+            std::chrono::steady_clock::time_point wakeup;
+        };
+        std::mutex _frames_mutex;
+        std::condition_variable _frames_available;
+        std::deque<queuedFrame> _frames;
+        std::function<void(bool)> _frame_ready;
+        bool _frames_closed;
+        void _queue_frame(frameLeaseT &&, std::chrono::steady_clock::time_point);
+        frameLeaseT _take_frame(std::unique_lock<std::mutex> &);
+        typedImageViewT _image_view(char *) const;
+
+        // scheduled triggers; one-shot triggers remove themselves after firing
+        std::mutex _timed_triggers_mutex;
+        std::vector<std::pair<triggerTimer *, size_t>> _timed_triggers;
+        size_t _schedule_trigger(triggerTimer &, std::chrono::system_clock::time_point, std::chrono::nanoseconds period);
+        void _cancel_triggers();
+
+        // per frame info messages; interval from frameLogInterval at construction
+        logRateLimiter _frame_log_limiter;
+
+        // dispatcher thread only; restarted there after capture was stopped
+        frameGapDetector _gap_detector;
+        std::atomic<bool> _gap_detector_restart;
+        std::mutex _gap_callback_mutex;
+        std::function<void(const frameGap &)> _gap_callback;
+        void _track_frame(const UEYEIMAGEINFO &);
+        void _report_gap(const frameGap &);
 
         // stop live and triggered
         void _stop_capture();
@@ -2,6 +2,12 @@
 
 #include "wrapper_helpers.h"
 #include "wrapper_types.h"
+#include "thread_helpers.h"
+#include "metrics.h"
+#include "event_reactor.h"
+#include "frame_scheduler.h"
+#include "fps_governor.h"
+#include "buffer_pool_scaler.h"
 namespace uEyeWrapper
 {
     template <imageColorMode M, imageBitDepth D>
@@ -15,10 +21,16 @@ namespace uEyeWrapper
 #include <selene/img/typed/ImageView.hpp>
 // #include <selene/img/typed/ImageViewAliases.hpp>
 
+#include <atomic>
 #include <functional>
 #include <chrono>
 #include <thread>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
 
 #include <plog/Logger.h>
 
@@ -26,6 +38,8 @@ namespace uEyeWrapper
 #define CAMERA_STARTER_FIRMWARE_UPLOAD_RETRIES 3
 #define CAMERA_CLOSE_RETRY_WAIT 10ms
 #define CAMERA_CLOSE_RETRIES 3
+// a triggered frame without frame event (e.g. failed transfer) stops blocking sequence shrinking after
+#define IMAGE_MEMORY_TRIGGER_TIMEOUT 1000ms
 
 #define IS_SET_EVENT_TERMINATE_HANDLE_THREADS IS_SET_EVENT_USER_DEFINED_BEGIN + 1
 static_assert(IS_SET_EVENT_TERMINATE_HANDLE_THREADS <= IS_SET_EVENT_USER_DEFINED_END);
@@ -37,9 +51,13 @@ namespace uEyeWrapper
     plog::Logger<0>& getLogger();
 
     void uploadProgressHandlerBar(uEyeCameraInfo camera, std::chrono::milliseconds duration, progress_state &state);
+    // calls are serialized by openCameras()
+    void uploadProgressHandlerFleetBar(const fleetUploadProgress &progress);
 
     // allocates and deallocates image buffers
     // keeps a reverse mapping from pointers to memory id, to be used in resolving memory id to get image info
+    // the sequence grows at any time; it shrinks only while no live capture runs, no triggered frame is in flight and no buffer is locked
+    // buffer count and bytes are published in the camera's metrics
     template <typename H>
     class imageMemoryManager : protected std::map<char *, INT>
     {
@@ -48,13 +66,39 @@ namespace uEyeWrapper
         void initialize();
         void cleanup();
 
+        // caller holds share() from retrieving the buffer address until the buffer is locked
         INT getID(char *) const;
+        bool contains(char *) const; // false for a stale frame event of a buffer removed from the sequence
+        // blocks shrinking the sequence; buffers are only freed while none is locked
+        std::shared_lock<std::shared_mutex> share() const;
+        // capture handles register while the driver captures into the sequence continuously (LIVE, not paused)
+        void capturing(bool started) const;
+        size_t captures() const;
+        // TRIGGER mode: called under share() right before is_FreezeVideo; the frame is in flight until a dispatcher
+        // calls frameArrived() under share() for its frame event, or for IMAGE_MEMORY_TRIGGER_TIMEOUT
+        void triggered() const;
+        void frameArrived() const;
+
+        // grows by appending buffers (is_AddToSequence), shrinks by rebuilding the sequence without the buffers added last
+        // shrinking is skipped while a live capture runs, a triggered frame is in flight or buffers are locked; triggers wait
+        // for the rebuild; returns the buffers in the sequence afterwards
+        size_t resize(size_t);
+        size_t buffers() const;
+        size_t bufferSize() const; // bytes requested per buffer
 
         ~imageMemoryManager();
 
     private:
         UEYE_API_CALL_PROTO();
         const H &_consumer_handle;
+
+        mutable std::shared_mutex _mutex;
+        std::vector<char *> _sequence; // in order of activation
+        mutable size_t _captures;       // running live capture handles
+        mutable std::atomic<size_t> _triggers_in_flight;
+        mutable std::atomic<int64_t> _last_trigger; // steady_clock [ns]
+        std::pair<char *, INT> _allocate();
+        void _publish();
     };
 
     // TODO: what callbacks? image, capture status change, errors in async loops?, conn/reconn?
@@ -77,7 +121,10 @@ namespace uEyeWrapper
         ~uEyeHandle();
 
         template <captureType C>
-        uEyeCaptureHandle<uEyeHandle<M, D>, C> getCaptureHandle(typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::imageCallbackT image_callback);
+        uEyeCaptureHandle<uEyeHandle<M, D>, C> getCaptureHandle(typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::imageCallbackT image_callback, std::vector<typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::subscriberCallbackT> subscribers = {});
+        // frames delivered in batches to one callback task, see batchPolicy
+        template <captureType C>
+        uEyeCaptureHandle<uEyeHandle<M, D>, C> getBatchCaptureHandle(typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::batchCallbackT batch_callback, batchPolicy policy = {});
 
         const uEyeCameraInfo &camera;
         // const double &FPS;
@@ -85,11 +132,43 @@ namespace uEyeWrapper
         const std::tuple<int, int> &resolution;
         const sensorType &sensor;
 
+        // may change the pixel clock; throws during an active LIVE capture, use setCaptureSettings() then
         double setFPS(double);
+        // change FPS and exposure, also during an active LIVE capture: the image dispatcher writes them between two frames,
+        // limited to the FPS range of the current pixel clock (throws otherwise); without live capture they apply at once, FPS through setFPS()
+        // returns the settings generation; frames captured with the new settings carry it as frameMetadata::settingsGeneration
+        uint64_t setCaptureSettings(captureSettings);
+        // adjust the frame rate to the load of the capture pipeline (locked buffers, queued frames, buffer lock errors), see fpsGovernor
+        // starts at policy.maxFPS and changes FPS through setCaptureSettings(), so the rate stays within the current pixel clock while live
+        void enableFPSGovernor(fpsGovernorPolicy);
+        void disableFPSGovernor(); // keeps the current rate
+        // empty without governor
+        std::optional<fpsGovernorState> governorState() const;
+        // grow the image buffer sequence when the driver runs out of buffers and shrink it again after calm periods, within
+        // policy.budget bytes and not below policy.minBuffers; see bufferPoolScaler. throws if the budget holds less than minBuffers
+        void enableBufferScaling(bufferPoolPolicy);
+        void disableBufferScaling(); // keeps the current buffers
+        // pixel clock chosen by following setFPS() calls; default minimal bandwidth
+        void setPixelClockObjective(pixelClockObjective);
         void setWhiteBalance(whiteBalance);
         void setWhiteBalance(int); // kelvin
         const captureErrors &errorStats;
 
+        // applies to the capture status observer immediately and to capture handles created afterwards
+        void setThreadPlacement(threadPlacement);
+        const threadPlacement &placement;
+
+        // hand event waiting over to a shared reactor: the capture status observer thread stops immediately,
+        // capture handles created afterwards run neither dispatcher nor pool threads and queue callbacks on the reactor's pool
+        // the reactor has to outlive this handle; can not be undone
+        void useReactor(eventReactor &);
+        // run image callbacks of capture handles created afterwards on a shared scheduler, e.g. frameScheduler::global()
+        // takes precedence over the pool of a reactor; the scheduler has to outlive this handle
+        void useScheduler(frameScheduler &, schedulingPolicy = {});
+
+        // per frame latencies, queue depth, locked buffers and frame rate of all capture handles on this camera
+        const cameraMetrics &metrics;
+
     private:
         UEYE_API_CALL_PROTO();
 
@@ -100,6 +179,7 @@ namespace uEyeWrapper
         // bool _freerun_active;
         std::tuple<int, int> _resolution; // {width, height}
         sensorType _sensor;
+        pixelClockObjective _pixel_clock_objective;
 
         const typename std::underlying_type_t<decltype(M)> _channels;
         const typename std::underlying_type_t<decltype(D)> _bit_depth;
@@ -113,11 +193,41 @@ namespace uEyeWrapper
         std::vector<UINT> _events;
 
         captureErrors _error_stats;
+        mutable cameraMetrics _metrics; // updated by capture handles holding a const reference
+
+        // captureSettings; handed to the dispatcher of a live capture handle, which holds a const reference
+        // _settings_write_mutex serializes setFPS()/setCaptureSettings() with each other and with live capture start and stop,
+        // taken before _settings_mutex
+        mutable std::mutex _settings_write_mutex;
+        mutable std::mutex _settings_mutex;
+        mutable std::optional<captureSettings> _pending_settings;
+        mutable uint64_t _settings_generation;     // latest written
+        mutable uint64_t _settings_effective_frame; // first frame number captured with it
+        mutable size_t _live_captures;
+        mutable std::mutex _governor_mutex;
+        std::unique_ptr<fpsGovernor> _governor;
+        std::mutex _scaler_mutex; // notified by the capture status observer
+        std::unique_ptr<bufferPoolScaler> _scaler;
+        // settings to write now (live capture handles, once the previous change is in effect) and generation of the frame
+        std::pair<std::optional<captureSettings>, uint64_t> _settings_for_frame(uint64_t frameNumber, bool live) const;
+        // returns pending settings to write at once when the last live capture stopped; caller holds _settings_write_lock()
+        std::optional<captureSettings> _live_capture(bool started) const;
+        std::unique_lock<std::mutex> _settings_write_lock() const;
+        double _set_FPS(double); // requires _settings_write_mutex
 
         std::thread _capture_status_observer_executor;
         void _SPAWN_capture_status_observer();
+        void _handle_capture_status_event();
+        eventReactor *_reactor; // nullptr: own threads
+        size_t _reactor_registration;
+        frameScheduler *_scheduler; // nullptr: own or reactor pool
+        schedulingPolicy _scheduling_policy;
         captureErrorCallbackT captureErrorCallback;
 
+        threadPlacement _thread_placement;
+        std::string _thread_name(const std::string &) const;
+        void _apply_observer_placement();
+
         void _open_camera(std::function<void(uEyeCameraInfo, std::chrono::milliseconds, progress_state &)> = uploadProgressHandlerBar);
         void _populate_sensor_info();
         void _init_events();
@@ -11,14 +11,51 @@
 #include "wrapper_types.h"
 #include "ueye_handle.h"
 
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <string>
+
+// per frame log messages of a capture handle are limited to one per interval
+#define UEYE_WRAPPER_FRAME_LOG_INTERVAL_MS_DEFAULT 1000
+// connection info of cameras is queried on every getCameraList() call by default
+#define UEYE_WRAPPER_CONNECTION_INFO_TTL_MS_DEFAULT 0
+// cameras opened at once by openCameras()
+#define UEYE_WRAPPER_OPEN_PARALLELISM_DEFAULT 8
+// interval of aggregated firmware upload progress updates
+#define UEYE_WRAPPER_FLEET_PROGRESS_INTERVAL 250ms
+
 namespace uEyeWrapper
 {
     // TODO: find saner implementation; concurrency impacts handles not the wrapper
     extern size_t concurrency;
+    // minimum interval between per frame log messages of a capture handle; 0 logs every frame
+    extern std::chrono::milliseconds frameLogInterval;
+    // time connection info (USB/ETH, IP) queried by getCameraList() is cached per device id; 0 disables the cache
+    extern std::chrono::milliseconds connectionInfoTTL;
+    // file caching settings resolved per camera model and serial number (pixel clocks, auto exposure and white balance defaults); empty disables the cache
+    extern std::string configCachePath;
     
     
+    // connection info of all cameras is queried concurrently
     cameraList getCameraList();
+    // drop cached connection info; e.g. after changing camera IP configuration
+    void clearConnectionInfoCache();
+
+    template <imageColorMode M, imageBitDepth D>
+    struct openResult
+    {
+        uEyeCameraInfo camera;
+        std::unique_ptr<uEyeHandle<M, D>> handle; // nullptr if opening failed
+        std::exception_ptr error;
+        std::chrono::milliseconds duration;
+    };
 
     template <imageColorMode M, imageBitDepth D>
     uEyeHandle<M, D> openCamera(const uEyeCameraInfo camera_info, typename uEyeHandle<M,D>::captureErrorCallbackT capture_error_callback = nullptr, std::function<void(uEyeCameraInfo, std::chrono::milliseconds, progress_state &)> fw_upload_progress_handler = uploadProgressHandlerBar);
+
+    // open many cameras concurrently, at most parallelism at once; results are in order of camera_infos
+    // failing to open a camera does not throw, the exception is returned in its result
+    template <imageColorMode M, imageBitDepth D>
+    std::vector<openResult<M, D>> openCameras(const cameraList &camera_infos, typename uEyeHandle<M, D>::captureErrorCallbackT capture_error_callback = nullptr, size_t parallelism = UEYE_WRAPPER_OPEN_PARALLELISM_DEFAULT, std::function<void(const fleetUploadProgress &)> fw_upload_progress_handler = uploadProgressHandlerFleetBar);
 }
\ No newline at end of file
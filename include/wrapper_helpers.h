@@ -3,7 +3,10 @@
 #include <tuple>
 #include <functional>
 #include <variant>
-// #include <type_traits>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <type_traits>
 
 #include <plog/Log.h>
 #include <fmt/core.h>
@@ -16,34 +19,57 @@
 
 // global or namespaced: UEYE_API_CALL_PROTO{ /* impl */ }
 // member declaration: UEYE_API_CALL_PROTO;
-#define UEYE_API_CALL_PROTO()                                                                                                                                                                                       \
-    template <typename FunctionRet, typename... FunctionArgs>                                                                                                                                                       \
-    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string f_name, const std::string caller_name, const int caller_line)                                        \
-    {                                                                                                                                                                                                               \
-        _api_wrapped(f, f_args, "", nullptr, f_name, caller_name, caller_line);                                                                                                                                     \
-    }                                                                                                                                                                                                               \
-    template <typename FunctionRet, typename... FunctionArgs>                                                                                                                                                       \
-    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string msg, const std::string f_name, const std::string caller_name, const int caller_line)                 \
-    {                                                                                                                                                                                                               \
-        _api_wrapped(f, f_args, msg, nullptr, f_name, caller_name, caller_line);                                                                                                                                    \
-    }                                                                                                                                                                                                               \
-    template <typename FunctionRet, typename... FunctionArgs>                                                                                                                                                       \
-    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, std::function<void()> cleanup_handler, const std::string f_name, const std::string caller_name, const int caller_line) \
-    {                                                                                                                                                                                                               \
-        _api_wrapped(f, f_args, "", cleanup_handler, f_name, caller_name, caller_line);                                                                                                                             \
-    }                                                                                                                                                                                                               \
-    template <typename FunctionRet, typename... FunctionArgs>                                                                                                                                                       \
-    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string msg, std::function<void()> cleanup_handler, const std::string f_name, const std::string caller_name, const int caller_line)
+// names are passed as string_view of literals and cleanup handlers as forwarding references; nothing is allocated or formatted on the success path
+// a cleanup handler may be any callable (including std::function); pass nullptr for none
+#define UEYE_API_CALL_PROTO()                                                                                                                                                                                                       \
+    template <typename FunctionRet, typename... FunctionArgs>                                                                                                                                                                       \
+    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string_view f_name, const std::string_view caller_name, const int caller_line)                                              \
+    {                                                                                                                                                                                                                               \
+        _api_wrapped(f, f_args, std::string_view(), nullptr, f_name, caller_name, caller_line);                                                                                                                                     \
+    }                                                                                                                                                                                                                               \
+    template <typename FunctionRet, typename... FunctionArgs>                                                                                                                                                                       \
+    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string_view msg, const std::string_view f_name, const std::string_view caller_name, const int caller_line)                  \
+    {                                                                                                                                                                                                                               \
+        _api_wrapped(f, f_args, msg, nullptr, f_name, caller_name, caller_line);                                                                                                                                                    \
+    }                                                                                                                                                                                                                               \
+    template <typename FunctionRet, typename... FunctionArgs, typename CleanupT, typename = std::enable_if_t<std::is_invocable_v<CleanupT &>>>                                                                                      \
+    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, CleanupT &&cleanup_handler, const std::string_view f_name, const std::string_view caller_name, const int caller_line)                  \
+    {                                                                                                                                                                                                                               \
+        _api_wrapped(f, f_args, std::string_view(), std::forward<CleanupT>(cleanup_handler), f_name, caller_name, caller_line);                                                                                                     \
+    }                                                                                                                                                                                                                               \
+    template <typename FunctionRet, typename... FunctionArgs, typename CleanupT>                                                                                                                                                    \
+    void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string_view msg, CleanupT &&cleanup_handler, const std::string_view f_name, const std::string_view caller_name, const int caller_line)
 
 // as class member: template<typename T> UEYE_API_CALL_MEMBER_DEF(uEyeHandle<M,D>){ /* impl */ }
-#define UEYE_API_CALL_MEMBER_DEF(...)                         \
-    template <typename FunctionRet, typename... FunctionArgs> \
-    void __VA_ARGS__::_api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string msg, std::function<void()> cleanup_handler, const std::string f_name, const std::string caller_name, const int caller_line)
+#define UEYE_API_CALL_MEMBER_DEF(...)                                             \
+    template <typename FunctionRet, typename... FunctionArgs, typename CleanupT> \
+    void __VA_ARGS__::_api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string_view msg, CleanupT &&cleanup_handler, const std::string_view f_name, const std::string_view caller_name, const int caller_line)
+
+// run a cleanup handler passed to _api_wrapped, if any
+template <typename CleanupT>
+void _api_cleanup(CleanupT &&cleanup_handler)
+{
+    if constexpr (std::is_null_pointer_v<std::decay_t<CleanupT>>)
+    {
+        return;
+    }
+    else if constexpr (std::is_constructible_v<bool, CleanupT &>)
+    {
+        if (cleanup_handler)
+        {
+            cleanup_handler();
+        }
+    }
+    else
+    {
+        cleanup_handler();
+    }
+}
 
 //// default wrapper implementation
 // fwd decl
-template <typename FunctionRet, typename... FunctionArgs>
-void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string msg, std::function<void()> cleanup_handler, const std::string f_name, const std::string caller_name, const int caller_line);
+template <typename FunctionRet, typename... FunctionArgs, typename CleanupT>
+void _api_wrapped(FunctionRet (*f)(FunctionArgs...), std::tuple<FunctionArgs...> f_args, const std::string_view msg, CleanupT &&cleanup_handler, const std::string_view f_name, const std::string_view caller_name, const int caller_line);
 // impl
 UEYE_API_CALL_PROTO()
 {
@@ -57,10 +83,10 @@ UEYE_API_CALL_PROTO()
             nret);
         PLOG_WARNING << fmt::format("[{}@{}] {}", caller_name, caller_line, common_msg);
 
-        if (cleanup_handler)
+        if constexpr (!std::is_null_pointer_v<std::decay_t<CleanupT>>)
         {
             PLOG_WARNING << fmt::format("[{}@{}] calling provided cleanup handler after failed call to {}()", caller_name, caller_line, f_name);
-            cleanup_handler();
+            _api_cleanup(std::forward<CleanupT>(cleanup_handler));
         }
 
         throw std::runtime_error(common_msg);
@@ -8,6 +8,10 @@
 #include <map>
 #include <functional>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <optional>
 
 #include <stdint.h>
 
@@ -21,6 +25,13 @@
 #endif
 
 
+// bounded capture error statistics: number of timestamps kept per error and rate window in seconds
+#define CAPTURE_ERROR_HISTORY_LENGTH 64
+#define CAPTURE_ERROR_RATE_WINDOW 60
+
+// frames already exposing when captureSettings are written between two frames of a live capture; they keep the old settings
+#define LIVE_SETTINGS_FRAME_DELAY 1
+
 // image type template parameter helpers
 #define uEye_MONO_8 uEyeWrapper::imageColorMode::MONO, uEyeWrapper::imageBitDepth::i8
 #define uEye_RGB_8 uEyeWrapper::imageColorMode::RGB, uEyeWrapper::imageBitDepth::i8
@@ -56,7 +67,15 @@ namespace uEyeWrapper
     enum class captureType
     {
         TRIGGER,
-        LIVE
+        LIVE,
+        SESSION // switches between TRIGGER (initially) and LIVE at runtime, see uEyeCaptureHandle::setCaptureType()
+    };
+
+    // pixel clock selected by setFPS()
+    enum class pixelClockObjective
+    {
+        minimalBandwidth, // lowest clock supporting the requested FPS
+        minimalLatency    // highest clock supporting the requested FPS; fastest sensor readout after exposure
     };
 
     // enum class colorMode
@@ -104,17 +123,193 @@ namespace uEyeWrapper
 
     typedef std::vector</*const*/ uEyeCameraInfo> cameraList;
 
-    struct captureError
+    // per frame information passed along with the image
+    struct frameMetadata
+    {
+        std::chrono::time_point<std::chrono::system_clock> timestamp; // driver system time of the capture
+        uint64_t deviceTimestamp;                                     // camera clock [0.1us]
+        uint64_t frameNumber;                                         // monotonic sequence counter
+        INT bufferId;                                                 // sequence buffer holding the image
+        uint64_t settingsGeneration;                                  // captureSettings in effect, see uEyeHandle::setCaptureSettings()
+    };
+
+    // frame rate and exposure changed together; unset values are kept
+    struct captureSettings
+    {
+        std::optional<double> FPS;
+        std::optional<double> exposure; // [ms]
+    };
+
+    // batched frame delivery: a batch is delivered once maxFrames frames arrived or maxWait passed since its first frame
+    // maxFrames is bounded by the sequence buffers at construction of the capture handle minus one, so the driver keeps a free buffer
+    struct batchPolicy
+    {
+        size_t maxFrames = 2;
+        std::chrono::microseconds maxWait{1000};
+    };
+
+    // frames missing from the sequence a capture handle delivered, see frameGapDetector
+    struct frameGap
     {
-        captureError(UEYE_CAPTURE_STATUS id, std::string name, std::string info) : id(id), name(name), info(info){};
+        enum cause : uint8_t
+        {
+            DEVICE_MISSED,  // never received from the camera: device timestamp interval or DEV_MISSED_IMAGES capture status
+            DRIVER_SKIPPED, // received by the driver, but not seen by the dispatcher: frame numbers skipped by is_GetActSeqBuf
+            POLICY_DROPPED, // seen by the dispatcher, released without reaching a consumer: full pull queue, batch buffers, maximum age
+        };
+
+        cause reason;
+        uint64_t frames;                                             // frames missing
+        uint64_t frameNumber;                                        // first frame after the gap; POLICY_DROPPED: the dropped frame
+        std::chrono::nanoseconds deviceInterval;                     // device timestamps across the gap; zero if not applicable
+        std::chrono::time_point<std::chrono::system_clock> detected; // wall clock time of detection
+    };
+
+    // placement of a cameras background threads; defaults keep OS scheduling
+    // cpu lists are sets of allowed cores (empty: no pinning); a dispatcherPriority > 0 requests SCHED_FIFO
+    struct threadPlacement
+    {
+        std::vector<int> dispatcherCPUs;
+        std::vector<int> workerCPUs;
+        std::vector<int> observerCPUs;
+        int dispatcherPriority = 0;
+
+        // prefix for thread names ("<prefix>-dsp", "<prefix>-obs", "<prefix>-wrk<n>"); empty: "ueye<device id>"
+        std::string namePrefix;
+    };
 
+    // point in time copy of a captureError; timestamps are most recent first
+    struct captureErrorSnapshot
+    {
         UEYE_CAPTURE_STATUS id;
         std::string name;
         std::string info;
+
+        uint64_t count;
+        uint64_t perSecond; // errors within the last full second
+        uint64_t perMinute; // errors within the last 60 full seconds
         std::vector<std::chrono::time_point<std::chrono::system_clock>> timestamps;
+    };
+
+    // error statistics with bounded memory: total count, ring of the most recent timestamps and per second buckets for rolling rates
+    // single writer (the capture status observer), any number of lock-free readers; snapshot() is consistent (seqlock)
+    struct captureError
+    {
+        captureError(UEYE_CAPTURE_STATUS id, std::string name, std::string info) : id(id), name(name), info(info), _sequence(0), _count(0), _driver_count(0)
+        {
+            for (size_t i = 0; i < CAPTURE_ERROR_RATE_WINDOW; i++)
+            {
+                _second_tags[i].store(-1, std::memory_order_relaxed);
+                _second_counts[i].store(0, std::memory_order_relaxed);
+            }
+            for (auto &timestamp : _history)
+            {
+                timestamp.store(0, std::memory_order_relaxed);
+            }
+        };
+        captureError(const captureError &) = delete;
+        captureError &operator=(const captureError &) = delete;
+
+        const UEYE_CAPTURE_STATUS id;
+        const std::string name;
+        const std::string info;
+
+        size_t count() const { return (size_t)_count.load(std::memory_order_acquire); };
+        uint64_t perSecond(std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now()) const { return _errors_in_window(now, 1); };
+        uint64_t perMinute(std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now()) const { return _errors_in_window(now, CAPTURE_ERROR_RATE_WINDOW); };
+
+        void add(std::chrono::time_point<std::chrono::system_clock> timestamp = std::chrono::system_clock::now(), uint64_t occurrences = 1)
+        {
+            if (!occurrences)
+            {
+                return;
+            }
+
+            const int64_t ticks = std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count();
+            const int64_t second = std::chrono::duration_cast<std::chrono::seconds>(timestamp.time_since_epoch()).count();
+            const size_t slot = (size_t)(second % CAPTURE_ERROR_RATE_WINDOW);
+            const uint64_t count = _count.load(std::memory_order_relaxed);
+
+            _sequence.fetch_add(1, std::memory_order_relaxed); // odd: write in progress
+            std::atomic_thread_fence(std::memory_order_release);
+
+            if (_second_tags[slot].load(std::memory_order_relaxed) != second)
+            {
+                _second_tags[slot].store(second, std::memory_order_relaxed);
+                _second_counts[slot].store(0, std::memory_order_relaxed);
+            }
+            _second_counts[slot].fetch_add(occurrences, std::memory_order_relaxed);
+
+            // all occurrences of one status update share its timestamp; only the history length is kept
+            for (uint64_t n = 0; n < std::min<uint64_t>(occurrences, CAPTURE_ERROR_HISTORY_LENGTH); n++)
+            {
+                _history[(count + n) % CAPTURE_ERROR_HISTORY_LENGTH].store(ticks, std::memory_order_relaxed);
+            }
+            _count.store(count + occurrences, std::memory_order_relaxed);
+
+            _sequence.fetch_add(1, std::memory_order_release); // even: consistent
+        };
+
+        captureErrorSnapshot snapshot(std::chrono::time_point<std::chrono::system_clock> now = std::chrono::system_clock::now()) const
+        {
+            captureErrorSnapshot snap{id, name, info, 0, 0, 0, {}};
+            snap.timestamps.reserve(CAPTURE_ERROR_HISTORY_LENGTH);
+
+            while (true)
+            {
+                const uint64_t sequence = _sequence.load(std::memory_order_acquire);
+                if (sequence & 1)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                snap.count = _count.load(std::memory_order_relaxed);
+                snap.perSecond = _errors_in_window(now, 1);
+                snap.perMinute = _errors_in_window(now, CAPTURE_ERROR_RATE_WINDOW);
 
-        size_t count() { return timestamps.size(); };
-        void add(std::chrono::time_point<std::chrono::system_clock> timestamp = std::chrono::system_clock::now()) { timestamps.push_back(timestamp); };
+                snap.timestamps.clear();
+                for (uint64_t n = 0; n < std::min<uint64_t>(snap.count, CAPTURE_ERROR_HISTORY_LENGTH); n++)
+                {
+                    const int64_t ticks = _history[(snap.count - 1 - n) % CAPTURE_ERROR_HISTORY_LENGTH].load(std::memory_order_relaxed);
+                    snap.timestamps.push_back(std::chrono::time_point<std::chrono::system_clock>(
+                        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ticks))));
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_sequence.load(std::memory_order_relaxed) == sequence)
+                {
+                    return snap;
+                }
+            }
+        };
+
+    private:
+        std::atomic<uint64_t> _sequence;
+        std::atomic<uint64_t> _count;
+        std::array<std::atomic<int64_t>, CAPTURE_ERROR_HISTORY_LENGTH> _history; // ns since epoch; ring indexed by running count
+        std::array<std::atomic<int64_t>, CAPTURE_ERROR_RATE_WINDOW> _second_tags; // epoch second the bucket currently counts
+        std::array<std::atomic<uint64_t>, CAPTURE_ERROR_RATE_WINDOW> _second_counts;
+
+        // cumulative driver counter at last update; writer only
+        uint64_t _driver_count;
+        friend struct captureErrors;
+
+        // errors in the last <seconds> full seconds before now
+        uint64_t _errors_in_window(std::chrono::time_point<std::chrono::system_clock> now, int64_t seconds) const
+        {
+            const int64_t current = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+            uint64_t errors = 0;
+            for (size_t i = 0; i < CAPTURE_ERROR_RATE_WINDOW; i++)
+            {
+                const int64_t tag = _second_tags[i].load(std::memory_order_relaxed);
+                if (tag < current && tag >= current - seconds)
+                {
+                    errors += _second_counts[i].load(std::memory_order_relaxed);
+                }
+            }
+            return errors;
+        };
     };
 
     struct captureErrors
@@ -159,20 +354,37 @@ namespace uEyeWrapper
                                        {IS_CAP_STATUS_ETH_BUFFER_OVERRUN, ETH_BUFFER_OVERRUN},
                                        {IS_CAP_STATUS_ETH_MISSED_IMAGES, ETH_MISSED_IMAGES}}){};
 
-        void update(UEYE_CAPTURE_STATUS_INFO status, std::chrono::time_point<std::chrono::system_clock> timestamp, std::function<void(const captureError)> onErrorCallback)
+        // driver counters are cumulative; only the increase since the last update is recorded and reported
+        void update(const UEYE_CAPTURE_STATUS_INFO &status, std::chrono::time_point<std::chrono::system_clock> timestamp, std::function<void(const captureError &)> onErrorCallback)
         {
             std::for_each(errorMapper.begin(), errorMapper.end(), [&](auto &errorMapping)
                           {
-                              if (status.adwCapStatusCnt_Detail[errorMapping.first])
+                              captureError &error = errorMapping.second;
+                              const uint64_t driver_count = status.adwCapStatusCnt_Detail[errorMapping.first];
+                              // counters have been reset if decreasing
+                              const uint64_t occurrences = driver_count >= error._driver_count ? driver_count - error._driver_count : driver_count;
+                              error._driver_count = driver_count;
+
+                              if (occurrences)
                               {
-                                  errorMapping.second.add(timestamp);
+                                  error.add(timestamp, occurrences);
                                   if (onErrorCallback)
                                   {
-                                      onErrorCallback(errorMapping.second);
+                                      onErrorCallback(error);
                                   }
                               }
                           });
         };
+
+        std::vector<captureErrorSnapshot> snapshot() const
+        {
+            const auto now = std::chrono::system_clock::now();
+            std::vector<captureErrorSnapshot> snapshots;
+            snapshots.reserve(errorMapper.size());
+            std::for_each(errorMapper.begin(), errorMapper.end(), [&](auto &errorMapping)
+                          { snapshots.push_back(errorMapping.second.snapshot(now)); });
+            return snapshots;
+        };
     };
 
     // for use in firmware upload progress feedback helper
@@ -182,4 +394,14 @@ namespace uEyeWrapper
         failure,
         complete
     };
+
+    // firmware upload progress of all cameras opened by one openCameras() call
+    struct fleetUploadProgress
+    {
+        size_t uploading;
+        size_t completed;
+        size_t failed;
+        double percent;                      // of the summed upload time estimates
+        std::chrono::milliseconds remaining; // estimate for the longest running upload
+    };
 }
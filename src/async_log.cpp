@@ -0,0 +1,228 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "async_log.h"
+
+#include <cstdio>
+
+// colorize console output like plog::ColorConsoleAppender
+#ifdef __linux__
+#include <unistd.h>
+#define STDOUTTTY isatty(fileno(stdout))
+#elif _WIN32
+#include <io.h>
+#define STDOUTTTY _isatty(_fileno(stdout))
+#else
+#define STDOUTTTY false
+#endif
+
+#include <fmt/core.h>
+
+namespace uEyeWrapper
+{
+    namespace
+    {
+        size_t round_up_to_power_of_two(size_t value)
+        {
+            size_t power = 2;
+            while (power < value)
+            {
+                power <<= 1;
+            }
+            return power;
+        }
+
+        const char *severity_color(plog::Severity severity)
+        {
+            switch (severity)
+            {
+            case plog::fatal:
+                return "\x1B[97m\x1B[41m";
+            case plog::error:
+                return "\x1B[91m";
+            case plog::warning:
+                return "\x1B[93m";
+            case plog::debug:
+            case plog::verbose:
+                return "\x1B[96m";
+            default:
+                return nullptr;
+            }
+        }
+
+        void append(std::string &out, const std::string &line)
+        {
+            out += line;
+        }
+
+#ifdef _WIN32
+        // plog formats to wide strings on windows by default
+        void append(std::string &out, const std::wstring &line)
+        {
+            out += plog::util::toNarrow(line, 0); // CP_ACP
+        }
+#endif
+    }
+
+    asyncLogWriter::asyncLogWriter(size_t capacity) : _mask(round_up_to_power_of_two(capacity) - 1),
+                                                      _slots(new slot[_mask + 1]),
+                                                      _enqueue_position(0),
+                                                      _dequeue_position(0),
+                                                      _queued(0),
+                                                      _written(0),
+                                                      _dropped(0),
+                                                      _running(false),
+                                                      _writer_waiting(false)
+    {
+        for (size_t i = 0; i <= _mask; i++)
+        {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    asyncLogWriter::~asyncLogWriter()
+    {
+        _running = false;
+        _wake_writer();
+        if (_writer.joinable())
+        {
+            _writer.join();
+        }
+    }
+
+    bool asyncLogWriter::push(plog::Severity severity, plog::util::nstring &&line)
+    {
+        std::call_once(_started, [this]()
+                       {
+                           _running = true;
+                           _writer = std::thread(&asyncLogWriter::_write, this); });
+
+        // bounded queue after D. Vyukov; claim a slot by advancing the enqueue position
+        size_t position = _enqueue_position.load(std::memory_order_relaxed);
+        slot *target;
+        while (true)
+        {
+            target = &_slots[position & _mask];
+            const size_t sequence = target->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0)
+            {
+                if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // full
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = _enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        target->severity = severity;
+        target->line = std::move(line);
+        target->sequence.store(position + 1, std::memory_order_release);
+        _queued.fetch_add(1, std::memory_order_relaxed);
+
+        if (_writer_waiting.load(std::memory_order_acquire))
+        {
+            _wake_writer();
+        }
+        return true;
+    }
+
+    void asyncLogWriter::flush()
+    {
+        const uint64_t queued = _queued.load(std::memory_order_relaxed);
+        while (_running && _written.load(std::memory_order_acquire) < queued)
+        {
+            _wake_writer();
+            std::this_thread::yield();
+        }
+    }
+
+    void asyncLogWriter::_wake_writer()
+    {
+        std::lock_guard<std::mutex> lock(_wake_mutex);
+        _wake.notify_one();
+    }
+
+    void asyncLogWriter::_write()
+    {
+        const bool color = STDOUTTTY;
+        uint64_t dropped_reported = 0;
+        std::string batch;
+
+        while (true)
+        {
+            const bool running = _running.load(std::memory_order_acquire);
+
+            // drain everything published so far into one write
+            uint64_t lines = 0;
+            while (true)
+            {
+                slot &source = _slots[_dequeue_position & _mask];
+                if (source.sequence.load(std::memory_order_acquire) != _dequeue_position + 1)
+                {
+                    break;
+                }
+
+                const char *highlight = color ? severity_color(source.severity) : nullptr;
+                if (highlight)
+                {
+                    batch += highlight;
+                }
+                append(batch, source.line);
+                if (highlight)
+                {
+                    batch += "\x1B[0m\x1B[0K";
+                }
+                source.line.clear();
+
+                source.sequence.store(_dequeue_position + _mask + 1, std::memory_order_release);
+                _dequeue_position++;
+                lines++;
+            }
+
+            const uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+            if (dropped != dropped_reported)
+            {
+                batch += fmt::format("uEye-wrapper: log queue full, dropped {} log lines\n", dropped - dropped_reported);
+                dropped_reported = dropped;
+            }
+
+            if (!batch.empty())
+            {
+                std::fwrite(batch.data(), 1, batch.size(), stdout);
+                std::fflush(stdout);
+                batch.clear();
+            }
+            _written.fetch_add(lines, std::memory_order_release);
+
+            if (lines)
+            {
+                continue;
+            }
+            if (!running)
+            {
+                break;
+            }
+
+            // idle: announce waiting, so producers wake us; the timeout covers a wakeup racing the announcement
+            std::unique_lock<std::mutex> lock(_wake_mutex);
+            _writer_waiting.store(true, std::memory_order_release);
+            _wake.wait_for(lock, std::chrono::milliseconds(ASYNC_LOG_WRITER_IDLE_WAIT_MS));
+            _writer_waiting.store(false, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,205 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "buffer_pool_scaler.h"
+#include "thread_helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <plog/Log.h>
+
+namespace uEyeWrapper
+{
+    bufferPoolScaler::bufferPoolScaler(bufferPoolPolicy policy, size_t minBuffers, size_t maxBuffers, sampleT sample, resizeT resize, std::string name) : _policy(policy),
+                                                                                                                                                         _min_buffers(minBuffers),
+                                                                                                                                                         _max_buffers(maxBuffers),
+                                                                                                                                                         _sample(std::move(sample)),
+                                                                                                                                                         _resize(std::move(resize)),
+                                                                                                                                                         _name(std::move(name)),
+                                                                                                                                                         _stop(false),
+                                                                                                                                                         _notified(false),
+                                                                                                                                                         _last_errors(0),
+                                                                                                                                                         _calm(0),
+                                                                                                                                                         _peak_locked(0),
+                                                                                                                                                         _budget_exhausted(false)
+    {
+        if (!minBuffers || minBuffers > maxBuffers)
+        {
+            throw std::logic_error("buffer pool scaler requires 0 < minBuffers <= buffers within budget");
+        }
+        if (policy.growth <= 0 || policy.shrinkBelow <= 0 || policy.shrinkBelow > 1 || policy.interval.count() <= 0 || !policy.calmIntervals)
+        {
+            throw std::logic_error("buffer pool scaler requires growth > 0, 0 < shrinkBelow <= 1, a positive interval and calmIntervals");
+        }
+
+        _last_errors = _sample().outOfBuffers;
+
+        _executor = std::thread(&bufferPoolScaler::_run, this);
+        set_thread_name(_executor.native_handle(), "ueye-pool");
+
+        PLOG_INFO << fmt::format("{} image buffer scaling running: {}-{} buffers",
+                                 _name,
+                                 minBuffers,
+                                 maxBuffers);
+    }
+
+    bufferPoolScaler::~bufferPoolScaler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wakeup.notify_all();
+        if (_executor.joinable())
+        {
+            _executor.join();
+        }
+    }
+
+    void bufferPoolScaler::notify()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _notified = true;
+        }
+        _wakeup.notify_all();
+    }
+
+    void bufferPoolScaler::_run()
+    {
+        const auto period = _policy.interval / BUFFER_POOL_SAMPLES;
+        auto next = std::chrono::steady_clock::now() + period;
+        unsigned int samples = 0;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _wakeup.wait_until(lock, next, [&]()
+                               { return _stop || _notified; });
+            if (_stop)
+            {
+                return;
+            }
+            _notified = false;
+
+            lock.unlock();
+            const auto sample = _sample();
+            const auto now = std::chrono::steady_clock::now();
+
+            if (sample.outOfBuffers != _last_errors)
+            {
+                _calm = 0;
+                _peak_locked = 0;
+                const uint64_t errors = sample.outOfBuffers - std::exchange(_last_errors, sample.outOfBuffers);
+                // errors right after growing stem from before the new buffers were in use
+                if (now - _grown >= period)
+                {
+                    PLOG_DEBUG << fmt::format("{} {} out-of-buffer errors with {} of {} buffers locked",
+                                              _name,
+                                              errors,
+                                              sample.lockedBuffers,
+                                              sample.buffers);
+                    _grow(sample);
+                    _grown = now;
+                }
+            }
+            else
+            {
+                _peak_locked = std::max(_peak_locked, sample.lockedBuffers);
+            }
+
+            if (now >= next)
+            {
+                next += period;
+                if (++samples == BUFFER_POOL_SAMPLES)
+                {
+                    samples = 0;
+                    _evaluate(sample);
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    void bufferPoolScaler::_grow(const bufferPoolSample &sample)
+    {
+        const size_t step = std::max<size_t>((size_t)std::ceil(_policy.growth * (double)sample.buffers), 1);
+        const size_t target = std::min(sample.buffers + step, _max_buffers);
+        if (target <= sample.buffers)
+        {
+            if (!std::exchange(_budget_exhausted, true))
+            {
+                PLOG_WARNING << fmt::format("{} out of image buffers; budget of {} buffers exhausted", _name, _max_buffers);
+            }
+            return;
+        }
+
+        try
+        {
+            const size_t buffers = _resize(target);
+            PLOG_INFO << fmt::format("{} out of image buffers; grew sequence from {} to {} buffers", _name, sample.buffers, buffers);
+        }
+        catch (const std::exception &e)
+        {
+            PLOG_WARNING << fmt::format("{} failed growing image buffer sequence to {} buffers: {}", _name, target, e.what());
+        }
+    }
+
+    void bufferPoolScaler::_evaluate(const bufferPoolSample &sample)
+    {
+        if (sample.live)
+        {
+            // calm intervals keep counting; shrinks once the capture stops
+            _calm = std::min(_calm + 1, _policy.calmIntervals);
+            return;
+        }
+
+        size_t target = _max_buffers;
+        if (sample.buffers <= _max_buffers)
+        {
+            _calm = std::min(_calm + 1, _policy.calmIntervals);
+            if (_calm < _policy.calmIntervals || sample.buffers <= _min_buffers)
+            {
+                return;
+            }
+            if ((double)_peak_locked >= _policy.shrinkBelow * (double)sample.buffers)
+            {
+                // buffers were in use; start another calm period
+                _calm = 0;
+                _peak_locked = 0;
+                return;
+            }
+            target = sample.buffers - 1;
+        }
+
+        try
+        {
+            const size_t buffers = _resize(target);
+            if (buffers >= sample.buffers)
+            {
+                // a triggered frame was in flight or frames were locked; retry next interval
+                return;
+            }
+            PLOG_INFO << fmt::format("{} image buffers idle; shrank sequence from {} to {} buffers", _name, sample.buffers, buffers);
+        }
+        catch (const std::exception &e)
+        {
+            PLOG_WARNING << fmt::format("{} failed shrinking image buffer sequence to {} buffers: {}", _name, target, e.what());
+            return;
+        }
+
+        _calm = 0;
+        _peak_locked = 0;
+        _budget_exhausted = false;
+    }
+}
@@ -0,0 +1,439 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "cluster_trigger.h"
+using namespace std::chrono_literals;
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <endian.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/core.h>
+
+#include <plog/Log.h>
+
+// "uEye" and protocol version
+#define CLUSTER_MESSAGE_MAGIC 0x75457965u
+#define CLUSTER_MESSAGE_VERSION 1u
+// encoded size: header word and six fields of 8 bytes
+#define CLUSTER_MESSAGE_SIZE 56
+// reports of this many recent triggers are kept
+#define CLUSTER_REPORT_HISTORY 1024
+
+namespace uEyeWrapper
+{
+    namespace
+    {
+        int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        uint64_t random_id()
+        {
+            std::random_device random;
+            return ((uint64_t)random() << 32) | random();
+        }
+
+#ifdef __linux__
+        int open_socket(const std::string &group, uint16_t port, const std::string &interface, std::vector<uint8_t> &destination)
+        {
+            in_addr group_address;
+            in_addr interface_address;
+            if (inet_pton(AF_INET, group.c_str(), &group_address) != 1 || inet_pton(AF_INET, interface.c_str(), &interface_address) != 1)
+            {
+                throw std::runtime_error(fmt::format("cluster trigger: invalid group {} or interface {}", group, interface));
+            }
+
+            int handle = socket(AF_INET, SOCK_DGRAM, 0);
+            if (handle < 0)
+            {
+                throw std::runtime_error("cluster trigger: failed to create socket");
+            }
+
+            // several processes per host share the port; every one of them receives all group messages
+            int reuse = 1;
+            setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+            sockaddr_in bind_address{};
+            bind_address.sin_family = AF_INET;
+            bind_address.sin_port = htons(port);
+            bind_address.sin_addr = group_address;
+
+            ip_mreq membership{};
+            membership.imr_multiaddr = group_address;
+            membership.imr_interface = interface_address;
+
+            unsigned char loop = 1;
+            unsigned char ttl = 1;
+            if (bind(handle, (sockaddr *)&bind_address, sizeof(bind_address)) != 0 ||
+                setsockopt(handle, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0 ||
+                setsockopt(handle, IPPROTO_IP, IP_MULTICAST_IF, &interface_address, sizeof(interface_address)) != 0 ||
+                setsockopt(handle, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0 ||
+                setsockopt(handle, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0)
+            {
+                close(handle);
+                throw std::runtime_error(fmt::format("cluster trigger: failed to join group {}:{} on {}", group, port, interface));
+            }
+
+            destination.assign((uint8_t *)&bind_address, (uint8_t *)&bind_address + sizeof(bind_address));
+            return handle;
+        }
+
+        void send_message(int handle, const std::vector<uint8_t> &destination, const clusterMessage &message)
+        {
+            const std::array<uint64_t, CLUSTER_MESSAGE_SIZE / 8> fields = {
+                htobe64(((uint64_t)CLUSTER_MESSAGE_MAGIC << 32) | (CLUSTER_MESSAGE_VERSION << 8) | message.kind),
+                htobe64(message.sender),
+                htobe64(message.peer),
+                htobe64(message.sequence),
+                htobe64((uint64_t)message.t1),
+                htobe64((uint64_t)message.t2),
+                htobe64((uint64_t)message.t3)};
+
+            if (sendto(handle, fields.data(), CLUSTER_MESSAGE_SIZE, 0, (const sockaddr *)destination.data(), (socklen_t)destination.size()) != CLUSTER_MESSAGE_SIZE)
+            {
+                PLOG_WARNING << fmt::format("cluster trigger: failed to send message of type {}", (int)message.kind);
+            }
+        }
+
+        // waits up to the timeout; empty on timeout or foreign packets
+        std::optional<clusterMessage> receive_message(int handle, int timeout_ms)
+        {
+            pollfd readable = {handle, POLLIN, 0};
+            if (poll(&readable, 1, timeout_ms) <= 0)
+            {
+                return std::nullopt;
+            }
+
+            std::array<uint64_t, CLUSTER_MESSAGE_SIZE / 8> fields;
+            if (recv(handle, fields.data(), CLUSTER_MESSAGE_SIZE, 0) != CLUSTER_MESSAGE_SIZE)
+            {
+                return std::nullopt;
+            }
+            for (auto &field : fields)
+            {
+                field = be64toh(field);
+            }
+            if ((fields[0] >> 32) != CLUSTER_MESSAGE_MAGIC || ((fields[0] >> 8) & 0xffffff) != CLUSTER_MESSAGE_VERSION)
+            {
+                return std::nullopt;
+            }
+
+            return clusterMessage{(clusterMessage::type)(fields[0] & 0xff), fields[1], fields[2], fields[3], (int64_t)fields[4], (int64_t)fields[5], (int64_t)fields[6]};
+        }
+#endif
+    }
+
+    clusterCoordinator::clusterCoordinator(std::string group, uint16_t port, std::string interface) : _socket(-1),
+                                                                                                     _id(random_id()),
+                                                                                                     _sequence(0),
+                                                                                                     _running(false)
+    {
+#ifdef __linux__
+        _socket = open_socket(group, port, interface, _destination);
+        _running = true;
+        _receiver = std::thread(&clusterCoordinator::_receive, this);
+
+        PLOG_INFO << fmt::format("cluster coordinator {:016x} running on {}:{} ({})", _id, group, port, interface);
+#else
+        throw std::runtime_error("cluster trigger: not supported on this platform");
+#endif
+    }
+
+    clusterCoordinator::~clusterCoordinator()
+    {
+        _running = false;
+        if (_receiver.joinable())
+        {
+            _receiver.join();
+        }
+#ifdef __linux__
+        if (_socket >= 0)
+        {
+            close(_socket);
+        }
+#endif
+    }
+
+    uint64_t clusterCoordinator::triggerAt(std::chrono::system_clock::time_point target)
+    {
+        uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            sequence = ++_sequence;
+            _reports[sequence] = {_active_participants()};
+            if (_reports.size() > CLUSTER_REPORT_HISTORY)
+            {
+                _reports.erase(_reports.begin());
+            }
+        }
+
+#ifdef __linux__
+        const clusterMessage trigger = {clusterMessage::TRIGGER, _id, 0, sequence, std::chrono::duration_cast<std::chrono::nanoseconds>(target.time_since_epoch()).count(), 0, 0};
+        for (int repeat = 0; repeat < CLUSTER_TRIGGER_REPEAT; repeat++)
+        {
+            send_message(_socket, _destination, trigger);
+        }
+#endif
+        return sequence;
+    }
+
+    size_t clusterCoordinator::participants() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _active_participants();
+    }
+
+    size_t clusterCoordinator::_active_participants() const
+    {
+        const auto now = std::chrono::steady_clock::now();
+        return (size_t)std::count_if(_participants.begin(), _participants.end(), [&](const auto &participant)
+                                     { return now - participant.second < CLUSTER_PARTICIPANT_TIMEOUT; });
+    }
+
+    std::optional<std::pair<std::chrono::nanoseconds, size_t>> clusterCoordinator::skew(uint64_t sequence) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto reports = _reports.find(sequence);
+        if (reports == _reports.end() || reports->second.received == 0)
+        {
+            return std::nullopt;
+        }
+        return std::make_pair(std::chrono::nanoseconds(reports->second.latest - reports->second.earliest), reports->second.received);
+    }
+
+    void clusterCoordinator::_receive()
+    {
+#ifdef __linux__
+        while (_running)
+        {
+            auto message = receive_message(_socket, CLUSTER_POLL_INTERVAL_MS);
+            const int64_t received = now_ns();
+            if (!message || message->sender == _id)
+            {
+                continue;
+            }
+
+            if (message->kind == clusterMessage::SYNC_REQUEST)
+            {
+                send_message(_socket, _destination, {clusterMessage::SYNC_RESPONSE, _id, message->sender, message->sequence, message->t1, received, now_ns()});
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (message->kind == clusterMessage::SYNC_REQUEST)
+            {
+                if (_participants.emplace(message->sender, std::chrono::steady_clock::now()).second)
+                {
+                    PLOG_INFO << fmt::format("cluster coordinator: participant {:016x} joined", message->sender);
+                }
+                _participants[message->sender] = std::chrono::steady_clock::now();
+            }
+            else if (message->kind == clusterMessage::REPORT)
+            {
+                auto reports = _reports.find(message->sequence);
+                if (reports == _reports.end())
+                {
+                    continue;
+                }
+
+                auto &trigger = reports->second;
+                trigger.earliest = trigger.received ? std::min(trigger.earliest, message->t1) : message->t1;
+                trigger.latest = trigger.received ? std::max(trigger.latest, message->t1) : message->t1;
+                if (++trigger.received == trigger.expected)
+                {
+                    _skews.record(std::chrono::nanoseconds(trigger.latest - trigger.earliest));
+                }
+            }
+        }
+#endif
+    }
+
+    clusterParticipant::clusterParticipant(triggerTimer &timer, std::string group, uint16_t port, std::string interface) : _timer(timer),
+                                                                                                                          _socket(-1),
+                                                                                                                          _id(random_id()),
+                                                                                                                          _next_trigger(0),
+                                                                                                                          _next_sample(0),
+                                                                                                                          _coordinator(0),
+                                                                                                                          _last_sequence(0),
+                                                                                                                          _triggered(0),
+                                                                                                                          _running(false)
+    {
+#ifdef __linux__
+        _socket = open_socket(group, port, interface, _destination);
+        _running = true;
+        _receiver = std::thread(&clusterParticipant::_receive, this);
+
+        PLOG_INFO << fmt::format("cluster participant {:016x} running on {}:{} ({})", _id, group, port, interface);
+#else
+        throw std::runtime_error("cluster trigger: not supported on this platform");
+#endif
+    }
+
+    clusterParticipant::~clusterParticipant()
+    {
+        _running = false;
+        if (_receiver.joinable())
+        {
+            _receiver.join();
+        }
+
+        // without the lock: cancel waits for a running trigger, which takes it; a trigger removes its id only when done
+        std::vector<size_t> scheduled;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            scheduled.swap(_scheduled);
+        }
+        for (auto id : scheduled)
+        {
+            _timer.cancel(id);
+        }
+
+#ifdef __linux__
+        if (_socket >= 0)
+        {
+            close(_socket);
+        }
+#endif
+    }
+
+    size_t clusterParticipant::add(std::function<void()> trigger)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _triggers.emplace_back(_next_trigger, std::move(trigger));
+        return _next_trigger++;
+    }
+
+    void clusterParticipant::remove(size_t id)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _triggers.erase(std::remove_if(_triggers.begin(), _triggers.end(), [id](const auto &trigger)
+                                       { return trigger.first == id; }),
+                        _triggers.end());
+    }
+
+    std::optional<std::chrono::nanoseconds> clusterParticipant::offset() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_best)
+        {
+            return std::nullopt;
+        }
+        return std::chrono::nanoseconds(_best->offset);
+    }
+
+    std::chrono::nanoseconds clusterParticipant::roundTrip() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return std::chrono::nanoseconds(_best ? _best->delay : 0);
+    }
+
+    void clusterParticipant::_schedule(uint64_t sequence, int64_t coordinator_time)
+    {
+        // with the lock held, so a trigger due immediately finds its id in _scheduled
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_best)
+        {
+            PLOG_WARNING << fmt::format("cluster participant {:016x}: no clock offset yet, skipping trigger {}", _id, sequence);
+            return;
+        }
+
+        const int64_t offset = _best->offset;
+        const int64_t local = coordinator_time - offset;
+        const uint64_t coordinator = _coordinator;
+        auto id = std::make_shared<size_t>(0);
+        *id = _timer.at(std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(local))), [this, id, coordinator, sequence, offset, local]()
+                        {
+                            const int64_t issued = now_ns();
+                            std::vector<std::pair<size_t, std::function<void()>>> triggers;
+                            {
+                                std::lock_guard<std::mutex> lock(_mutex);
+                                triggers = _triggers;
+                            }
+                            for (auto &trigger : triggers)
+                            {
+                                trigger.second();
+                            }
+                            _triggered.fetch_add(1, std::memory_order_relaxed);
+#ifdef __linux__
+                            send_message(_socket, _destination, {clusterMessage::REPORT, _id, coordinator, sequence, issued + offset, issued - local, 0});
+#endif
+
+                            // last access to members: until here the destructor finds the id and waits for this task
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            _scheduled.erase(std::remove(_scheduled.begin(), _scheduled.end(), *id), _scheduled.end());
+                        });
+        _scheduled.push_back(*id);
+    }
+
+    void clusterParticipant::_receive()
+    {
+#ifdef __linux__
+        uint64_t requests = 0;
+        auto next_sync = std::chrono::steady_clock::now();
+        while (_running)
+        {
+            if (std::chrono::steady_clock::now() >= next_sync)
+            {
+                send_message(_socket, _destination, {clusterMessage::SYNC_REQUEST, _id, 0, ++requests, now_ns(), 0, 0});
+                next_sync += CLUSTER_SYNC_INTERVAL;
+            }
+
+            auto message = receive_message(_socket, CLUSTER_POLL_INTERVAL_MS);
+            const int64_t received = now_ns();
+            if (!message || message->sender == _id)
+            {
+                continue;
+            }
+
+            if (message->kind == clusterMessage::SYNC_RESPONSE && message->peer == _id)
+            {
+                // NTP: offset = ((t2 - t1) + (t3 - t4)) / 2, round trip without the coordinator's processing
+                const syncSample sample = {((message->t2 - message->t1) + (message->t3 - received)) / 2,
+                                           (received - message->t1) - (message->t3 - message->t2)};
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_samples.size() < CLUSTER_SYNC_SAMPLES)
+                {
+                    _samples.push_back(sample);
+                }
+                else
+                {
+                    _samples[_next_sample] = sample;
+                }
+                _next_sample = (_next_sample + 1) % CLUSTER_SYNC_SAMPLES;
+                _best = *std::min_element(_samples.begin(), _samples.end(), [](const auto &a, const auto &b)
+                                          { return a.delay < b.delay; });
+            }
+            else if (message->kind == clusterMessage::TRIGGER)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (message->sender == _coordinator && message->sequence <= _last_sequence)
+                    {
+                        continue; // repetition
+                    }
+                    _coordinator = message->sender;
+                    _last_sequence = message->sequence;
+                }
+                _schedule(message->sequence, message->t1);
+            }
+        }
+#endif
+    }
+}
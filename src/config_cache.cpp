@@ -0,0 +1,220 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "config_cache.h"
+#include "ueye_wrapper.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <fmt/core.h>
+
+#include <plog/Log.h>
+
+// file format, one value per line, tab separated:
+// <model>  <serial>  clock           <FPS>  <pixel clock>
+// <model>  <serial>  aes             <hex bytes>
+// <model>  <serial>  wb_color_model  <color model>
+// <model>  <serial>  wb_range        <min>  <max>
+#define CAMERA_CONFIG_CACHE_HEADER "# uEye-wrapper camera config cache v{}"
+
+namespace uEyeWrapper
+{
+    namespace
+    {
+        std::vector<std::string> split_fields(const std::string &line)
+        {
+            std::vector<std::string> fields;
+            std::istringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, '\t'))
+            {
+                fields.push_back(field);
+            }
+            return fields;
+        }
+
+        std::string to_hex(const std::vector<char> &bytes)
+        {
+            std::string hex;
+            hex.reserve(bytes.size() * 2);
+            for (const char byte : bytes)
+            {
+                hex += fmt::format("{:02x}", (unsigned char)byte);
+            }
+            return hex;
+        }
+
+        std::vector<char> from_hex(const std::string &hex)
+        {
+            if (hex.size() % 2)
+            {
+                throw std::runtime_error("odd number of hex digits");
+            }
+            std::vector<char> bytes(hex.size() / 2);
+            for (size_t i = 0; i < bytes.size(); i++)
+            {
+                bytes[i] = (char)std::stoul(hex.substr(2 * i, 2), nullptr, 16);
+            }
+            return bytes;
+        }
+    }
+
+    cameraConfigCache &cameraConfigCache::global()
+    {
+        static cameraConfigCache cache;
+        return cache;
+    }
+
+    cameraConfigCacheEntry cameraConfigCache::get(const uEyeCameraInfo &camera)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_sync_path())
+        {
+            return {};
+        }
+
+        auto entry = _entries.find({camera.modelName, camera.serialNo});
+        return entry == _entries.end() ? cameraConfigCacheEntry() : entry->second;
+    }
+
+    void cameraConfigCache::update(const uEyeCameraInfo &camera, const std::function<void(cameraConfigCacheEntry &)> &modify)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_sync_path())
+        {
+            return;
+        }
+
+        modify(_entries[{camera.modelName, camera.serialNo}]);
+        _store();
+    }
+
+    void cameraConfigCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_sync_path())
+        {
+            _entries.clear();
+            _store();
+        }
+    }
+
+    bool cameraConfigCache::_sync_path()
+    {
+        if (configCachePath != _path)
+        {
+            _path = configCachePath;
+            _entries.clear();
+            if (!_path.empty())
+            {
+                _load();
+            }
+        }
+        return !_path.empty();
+    }
+
+    void cameraConfigCache::_load()
+    {
+        std::ifstream file(_path);
+        std::string line;
+        if (!file || !std::getline(file, line))
+        {
+            PLOG_DEBUG << fmt::format("camera config cache {} not present; starting empty", _path);
+            return;
+        }
+        if (line != fmt::format(CAMERA_CONFIG_CACHE_HEADER, CAMERA_CONFIG_CACHE_VERSION))
+        {
+            PLOG_WARNING << fmt::format("camera config cache {} has unknown version; ignoring", _path);
+            return;
+        }
+
+        size_t lines = 0;
+        while (std::getline(file, line))
+        {
+            const auto fields = split_fields(line);
+            try
+            {
+                if (fields.size() < 4)
+                {
+                    throw std::runtime_error("missing fields");
+                }
+
+                auto &entry = _entries[{fields[0], fields[1]}];
+                if (fields[2] == "clock" && fields.size() == 5)
+                {
+                    entry.pixelClock[std::stod(fields[3])] = (UINT)std::stoul(fields[4]);
+                }
+                else if (fields[2] == "aes")
+                {
+                    entry.aesDefault = from_hex(fields[3]);
+                }
+                else if (fields[2] == "wb_color_model")
+                {
+                    entry.wbColorModelDefault = (UINT)std::stoul(fields[3]);
+                }
+                else if (fields[2] == "wb_range" && fields.size() == 5)
+                {
+                    entry.wbTemperatureRange = std::make_tuple((UINT)std::stoul(fields[3]), (UINT)std::stoul(fields[4]));
+                }
+                else
+                {
+                    throw std::runtime_error("unknown value");
+                }
+                lines++;
+            }
+            catch (const std::exception &e)
+            {
+                PLOG_WARNING << fmt::format("camera config cache {}: skipping invalid line '{}' ({})", _path, line, e.what());
+            }
+        }
+
+        PLOG_INFO << fmt::format("camera config cache {}: loaded {} values for {} cameras", _path, lines, _entries.size());
+    }
+
+    void cameraConfigCache::_store() const
+    {
+        // write and rename; never leave a partially written cache behind
+        const std::string temporary = _path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::trunc);
+            file << fmt::format(CAMERA_CONFIG_CACHE_HEADER, CAMERA_CONFIG_CACHE_VERSION) << "\n";
+            for (const auto &[key, entry] : _entries)
+            {
+                const auto &[model, serial] = key;
+                for (const auto &[FPS, clock] : entry.pixelClock)
+                {
+                    file << fmt::format("{}\t{}\tclock\t{}\t{}\n", model, serial, FPS, clock);
+                }
+                if (!entry.aesDefault.empty())
+                {
+                    file << fmt::format("{}\t{}\taes\t{}\n", model, serial, to_hex(entry.aesDefault));
+                }
+                if (entry.wbColorModelDefault)
+                {
+                    file << fmt::format("{}\t{}\twb_color_model\t{}\n", model, serial, *entry.wbColorModelDefault);
+                }
+                if (entry.wbTemperatureRange)
+                {
+                    file << fmt::format("{}\t{}\twb_range\t{}\t{}\n", model, serial, std::get<0>(*entry.wbTemperatureRange), std::get<1>(*entry.wbTemperatureRange));
+                }
+            }
+            if (!file.flush())
+            {
+                PLOG_WARNING << fmt::format("camera config cache {}: writing failed", temporary);
+                return;
+            }
+        }
+
+        if (std::rename(temporary.c_str(), _path.c_str()) != 0)
+        {
+            PLOG_WARNING << fmt::format("camera config cache {}: replacing failed", _path);
+        }
+    }
+}
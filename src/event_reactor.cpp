@@ -0,0 +1,179 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "event_reactor.h"
+#include "thread_helpers.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <utility>
+using namespace std::chrono_literals;
+
+#include <fmt/core.h>
+
+#include <plog/Log.h>
+
+namespace uEyeWrapper
+{
+    eventReactor::eventReactor(size_t threads, size_t workers) : _running(true),
+                                                                 _next_id(1),
+                                                                 _pool((unsigned int)std::max<size_t>(workers, 1))
+    {
+        threads = std::max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; i++)
+        {
+            _shards.push_back(std::make_unique<shard>());
+        }
+        for (size_t i = 0; i < threads; i++)
+        {
+            shard &own = *_shards[i];
+            own.executor = std::thread(&eventReactor::_poll, this, std::ref(own));
+            set_thread_name(own.executor.native_handle(), fmt::format("ueye-rct{}", i));
+        }
+
+        PLOG_INFO << fmt::format("event reactor running on {} threads; using pool with {} threads for callback execution", threads, _pool.get_thread_count());
+    }
+
+    eventReactor::~eventReactor()
+    {
+        _running = false;
+        for (auto &own : _shards)
+        {
+            if (own->executor.joinable())
+            {
+                own->executor.join();
+            }
+        }
+        _pool.wait_for_tasks();
+    }
+
+    size_t eventReactor::add(HIDS handle, UINT event, std::function<void()> handler)
+    {
+        const size_t id = _next_id++;
+
+        // least loaded thread
+        shard *target = _shards.front().get();
+        size_t load = SIZE_MAX;
+        for (auto &own : _shards)
+        {
+            std::lock_guard<std::mutex> lock(own->mutex);
+            if (own->registrations.size() < load)
+            {
+                load = own->registrations.size();
+                target = own.get();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(target->mutex);
+        target->registrations.push_back({id, handle, event, std::move(handler)});
+        PLOG_DEBUG << fmt::format("event reactor: registered event {} of handle {:#010x} as #{}", event, handle, id);
+        return id;
+    }
+
+    void eventReactor::remove(size_t id)
+    {
+        for (auto &own : _shards)
+        {
+            std::unique_lock<std::mutex> lock(own->mutex);
+            auto registration = std::find_if(own->registrations.begin(), own->registrations.end(), [id](const auto &r)
+                                             { return r.id == id; });
+            if (registration == own->registrations.end())
+            {
+                continue;
+            }
+
+            if (own->running == id)
+            {
+                if (std::this_thread::get_id() == own->executor.get_id())
+                {
+                    // the polling thread erases it once the handler returned
+                    own->remove_running = true;
+                    PLOG_DEBUG << fmt::format("event reactor: removing registration #{} after its running handler", id);
+                    return;
+                }
+                own->handled.wait(lock, [&]()
+                                  { return own->running != id; });
+            }
+
+            own->registrations.erase(registration);
+            PLOG_DEBUG << fmt::format("event reactor: removed registration #{}", id);
+            return;
+        }
+    }
+
+    void eventReactor::_poll(shard &own)
+    {
+        size_t idle_rounds = 0;
+        auto sleep = std::chrono::duration_cast<std::chrono::microseconds>(EVENT_REACTOR_MIN_SLEEP);
+
+        while (_running.load(std::memory_order_relaxed))
+        {
+            bool signaled = false;
+            {
+                std::unique_lock<std::mutex> lock(own.mutex);
+                for (auto registration = own.registrations.begin(); registration != own.registrations.end();)
+                {
+                    UINT event = registration->event;
+                    IS_WAIT_EVENTS wait_events = {&event, 1, FALSE, 0, 0, 0};
+                    if (is_Event(registration->handle, IS_EVENT_CMD_WAIT, &wait_events, sizeof(wait_events)) != IS_SUCCESS || wait_events.nSignaled != event)
+                    {
+                        registration++;
+                        continue;
+                    }
+
+                    // the handler may add or remove registrations, e.g. a consumer resumed inline releasing its capture handle;
+                    // remove() of this registration waits for it
+                    signaled = true;
+                    own.running = registration->id;
+                    lock.unlock();
+                    try
+                    {
+                        registration->handler();
+                    }
+                    catch (const std::exception &e)
+                    {
+                        PLOG_ERROR << fmt::format("event reactor: handler of registration #{} failed: {}", registration->id, e.what());
+                    }
+                    catch (...)
+                    {
+                        PLOG_ERROR << fmt::format("event reactor: handler of registration #{} failed", registration->id);
+                    }
+                    lock.lock();
+                    own.running = 0;
+                    own.handled.notify_all();
+
+                    if (std::exchange(own.remove_running, false))
+                    {
+                        PLOG_DEBUG << fmt::format("event reactor: removed registration #{}", registration->id);
+                        registration = own.registrations.erase(registration);
+                    }
+                    else
+                    {
+                        registration++;
+                    }
+                }
+            }
+
+            if (signaled)
+            {
+                idle_rounds = 0;
+                sleep = EVENT_REACTOR_MIN_SLEEP;
+            }
+            else if (++idle_rounds < EVENT_REACTOR_SPIN_ROUNDS)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for(sleep);
+                sleep = std::min<std::chrono::microseconds>(sleep * 2, EVENT_REACTOR_MAX_SLEEP);
+            }
+        }
+    }
+}
@@ -0,0 +1,206 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "fps_governor.h"
+#include "thread_helpers.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <plog/Log.h>
+
+namespace uEyeWrapper
+{
+    fpsGovernor::fpsGovernor(fpsGovernorPolicy policy, sampleT sample, applyT apply, std::string name) : _policy(policy),
+                                                                                                        _sample(std::move(sample)),
+                                                                                                        _apply(std::move(apply)),
+                                                                                                        _name(std::move(name)),
+                                                                                                        _stop(false),
+                                                                                                        _state({policy.maxFPS, 0, 0, 0}),
+                                                                                                        _ceiling(policy.maxFPS),
+                                                                                                        _calm(0),
+                                                                                                        _unchanged(0),
+                                                                                                        _cooldown(false),
+                                                                                                        _last_errors(0)
+    {
+        if (policy.maxFPS <= 0 || policy.minFPS <= 0 || policy.minFPS > policy.maxFPS)
+        {
+            throw std::logic_error("frame rate governor requires 0 < minFPS <= maxFPS");
+        }
+        if (policy.decrease <= 0 || policy.decrease >= 1 || policy.increase <= 0 || policy.lowWater > policy.highWater || policy.interval.count() <= 0)
+        {
+            throw std::logic_error("frame rate governor requires 0 < decrease < 1, increase > 0, lowWater <= highWater and a positive interval");
+        }
+        if (!policy.calmIntervals || !policy.probeIntervals || !policy.steadyIntervals)
+        {
+            throw std::logic_error("frame rate governor requires positive interval counts");
+        }
+
+        _last_errors = _sample().lockErrors;
+        _apply(policy.maxFPS);
+
+        _executor = std::thread(&fpsGovernor::_run, this);
+        set_thread_name(_executor.native_handle(), "ueye-gov");
+
+        PLOG_INFO << fmt::format("{} frame rate governor running: {}-{} FPS, evaluated every {}ms",
+                                 _name,
+                                 policy.minFPS,
+                                 policy.maxFPS,
+                                 policy.interval.count());
+    }
+
+    fpsGovernor::~fpsGovernor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _stop_requested.notify_all();
+        if (_executor.joinable())
+        {
+            _executor.join();
+        }
+    }
+
+    fpsGovernorState fpsGovernor::state() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _state;
+    }
+
+    void fpsGovernor::_run()
+    {
+        const auto period = _policy.interval / FPS_GOVERNOR_SAMPLES;
+        auto next = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop)
+        {
+            double locked = 0;
+            double queued = 0;
+            uint64_t errors = 0;
+            for (int n = 0; n < FPS_GOVERNOR_SAMPLES && !_stop; n++)
+            {
+                next += period;
+                if (_stop_requested.wait_until(lock, next, [&]()
+                                               { return _stop; }))
+                {
+                    return;
+                }
+
+                lock.unlock();
+                const auto sample = _sample();
+                lock.lock();
+                locked += sample.lockedShare;
+                queued += sample.queuedShare;
+                errors = sample.lockErrors;
+            }
+
+            lock.unlock();
+            _evaluate(locked / FPS_GOVERNOR_SAMPLES, queued / FPS_GOVERNOR_SAMPLES, errors);
+            lock.lock();
+        }
+    }
+
+    void fpsGovernor::_evaluate(double lockedShare, double queuedShare, uint64_t errors)
+    {
+        const uint64_t new_errors = errors - std::exchange(_last_errors, errors);
+        const double FPS = state().FPS;
+        if (std::exchange(_cooldown, false))
+        {
+            // buffers and queue drain only after the new rate took effect
+            return;
+        }
+
+        if (new_errors || lockedShare >= _policy.highWater || queuedShare >= 1)
+        {
+            _calm = 0;
+            _ceiling = FPS;
+            const double lowered = std::max(FPS * _policy.decrease, _policy.minFPS);
+            if (lowered < FPS)
+            {
+                PLOG_DEBUG << fmt::format("{} pipeline saturated ({} lock errors, {:.2f} buffers locked, {:.2f} queued); lowering to {} FPS",
+                                          _name,
+                                          new_errors,
+                                          lockedShare,
+                                          queuedShare,
+                                          lowered);
+                std::lock_guard<std::mutex> lock(_mutex);
+                _state.decreases++;
+            }
+            _set(lowered);
+            return;
+        }
+
+        if (lockedShare > _policy.lowWater || queuedShare > 0)
+        {
+            // between the water marks: hold
+            _calm = 0;
+            _set(FPS);
+            return;
+        }
+
+        if (++_calm % _policy.probeIntervals == 0)
+        {
+            _ceiling = _policy.maxFPS;
+        }
+        if (_calm % _policy.calmIntervals == 0)
+        {
+            // stay below the rate that saturated last
+            const double step = _policy.increase * _policy.maxFPS;
+            const double raised = std::min({FPS + step, _ceiling - step, _policy.maxFPS});
+            if (raised > FPS)
+            {
+                PLOG_DEBUG << fmt::format("{} pipeline calm; raising to {} FPS", _name, raised);
+                _set(raised);
+                std::lock_guard<std::mutex> lock(_mutex);
+                _state.increases++;
+                return;
+            }
+        }
+        _set(FPS);
+    }
+
+    void fpsGovernor::_set(double FPS)
+    {
+        double current;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            current = _state.FPS;
+        }
+
+        if (FPS == current)
+        {
+            if (++_unchanged == _policy.steadyIntervals)
+            {
+                PLOG_INFO << fmt::format("{} frame rate governor settled at {} FPS", _name, FPS);
+                std::lock_guard<std::mutex> lock(_mutex);
+                _state.steadyFPS = FPS;
+            }
+            return;
+        }
+
+        try
+        {
+            _apply(FPS);
+        }
+        catch (const std::exception &e)
+        {
+            PLOG_WARNING << fmt::format("{} frame rate governor failed setting {} FPS: {}", _name, FPS, e.what());
+            return;
+        }
+
+        _unchanged = 0;
+        _cooldown = true;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _state.FPS = FPS;
+    }
+}
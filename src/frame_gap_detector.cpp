@@ -0,0 +1,88 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "frame_gap_detector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace uEyeWrapper
+{
+    frameGapDetector::frameGapDetector(bool periodic, uint64_t deviceMissed) : _periodic(periodic),
+                                                                              _last_frame(0),
+                                                                              _last_timestamp(0),
+                                                                              _period(0),
+                                                                              _intervals(0),
+                                                                              _device_missed(deviceMissed)
+    {
+    }
+
+    std::optional<frameGap> frameGapDetector::frame(uint64_t frameNumber, uint64_t deviceTimestamp, uint64_t deviceMissed)
+    {
+        const uint64_t last_frame = std::exchange(_last_frame, frameNumber);
+        const uint64_t last_timestamp = std::exchange(_last_timestamp, deviceTimestamp);
+
+        if (!last_frame || frameNumber <= last_frame || deviceTimestamp <= last_timestamp)
+        {
+            // first frame or restarted sequence
+            _intervals = 0;
+            _device_missed = std::max(_device_missed, deviceMissed);
+            return std::nullopt;
+        }
+
+        const uint64_t interval = deviceTimestamp - last_timestamp;
+        const auto gap = [&](frameGap::cause reason, uint64_t frames) -> std::optional<frameGap>
+        {
+            return frameGap{reason, frames, frameNumber, std::chrono::nanoseconds(interval * 100), std::chrono::system_clock::now()};
+        };
+
+        if (frameNumber - last_frame > 1)
+        {
+            // the interval spans frames the driver received; not a sample of the frame period
+            return gap(frameGap::DRIVER_SKIPPED, frameNumber - last_frame - 1);
+        }
+
+        if (_periodic && _intervals >= FRAME_GAP_WARMUP && interval > FRAME_GAP_INTERVAL_FACTOR * _period)
+        {
+            const uint64_t missed = std::max<uint64_t>((uint64_t)std::llround((double)interval / _period), 2) - 1;
+            _device_missed += missed;
+            // a lasting frame rate decrease shows as missed frames until the period followed it
+            _period += FRAME_GAP_PERIOD_ALPHA * ((double)interval - _period);
+            return gap(frameGap::DEVICE_MISSED, missed);
+        }
+
+        _period = _intervals ? _period + FRAME_GAP_PERIOD_ALPHA * ((double)interval - _period) : (double)interval;
+        _intervals++;
+
+        if (deviceMissed > _device_missed)
+        {
+            const uint64_t missed = deviceMissed - std::exchange(_device_missed, deviceMissed);
+            return frameGap{frameGap::DEVICE_MISSED, missed, frameNumber, std::chrono::nanoseconds(0), std::chrono::system_clock::now()};
+        }
+        return std::nullopt;
+    }
+
+    void frameGapDetector::resetPeriod()
+    {
+        _intervals = 0;
+    }
+
+    void frameGapDetector::restart(bool periodic)
+    {
+        _periodic = periodic;
+        _last_frame = 0;
+        _last_timestamp = 0;
+        _intervals = 0;
+    }
+
+    std::chrono::nanoseconds frameGapDetector::period() const
+    {
+        return _intervals >= FRAME_GAP_WARMUP ? std::chrono::nanoseconds((int64_t)(_period * 100)) : std::chrono::nanoseconds(0);
+    }
+}
@@ -0,0 +1,242 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "frame_scheduler.h"
+#include "thread_helpers.h"
+
+#include <algorithm>
+
+#include <fmt/core.h>
+
+#include <plog/Log.h>
+
+namespace uEyeWrapper
+{
+    class frameScheduler::group
+    {
+    public:
+        group(schedulingPolicy policy, size_t workers, const std::string &name) : name(name),
+                                                                                  weight(std::max(policy.weight, 1u)),
+                                                                                  concurrency(policy.maxConcurrency ? std::min(policy.maxConcurrency, workers) : workers){};
+
+        const std::string name;
+        const unsigned int weight;
+        const size_t concurrency;
+
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::deque<std::function<void()>> tasks;
+        size_t tokens = 0;     // queued or held by a worker; at most concurrency
+        size_t running = 0;    // tokens executing a task
+        size_t unfinished = 0; // queued and running tasks
+    };
+
+    namespace
+    {
+        // worker identity of the calling thread; tokens submitted from a worker stay on its deque
+        thread_local const frameScheduler *current_scheduler = nullptr;
+        thread_local size_t current_worker = 0;
+    }
+
+    frameScheduler::frameScheduler(size_t workers) : _next_worker(0),
+                                                     _queued_tokens(0),
+                                                     _running(true),
+                                                     _sleeping(0),
+                                                     _executed(0),
+                                                     _steals(0)
+    {
+        workers = std::max<size_t>(workers, 1);
+        for (size_t i = 0; i < workers; i++)
+        {
+            _workers.push_back(std::make_unique<worker>());
+        }
+        for (size_t i = 0; i < workers; i++)
+        {
+            _workers[i]->executor = std::thread(&frameScheduler::_work, this, i);
+            set_thread_name(_workers[i]->executor.native_handle(), fmt::format("ueye-sch{}", i));
+        }
+
+        PLOG_INFO << fmt::format("frame scheduler running with {} workers", workers);
+    }
+
+    frameScheduler::~frameScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _running = false;
+            _wake.notify_all();
+        }
+        for (auto &own : _workers)
+        {
+            if (own->executor.joinable())
+            {
+                own->executor.join();
+            }
+        }
+    }
+
+    frameScheduler &frameScheduler::global()
+    {
+        static frameScheduler scheduler;
+        return scheduler;
+    }
+
+    std::shared_ptr<frameScheduler::group> frameScheduler::addGroup(schedulingPolicy policy, const std::string &name)
+    {
+        auto added = std::make_shared<group>(policy, _workers.size(), name);
+        PLOG_DEBUG << fmt::format("frame scheduler: added group {} with weight {} and concurrency {}", name, added->weight, added->concurrency);
+        return added;
+    }
+
+    void frameScheduler::submit(const std::shared_ptr<group> &target, std::function<void()> task)
+    {
+        bool schedule;
+        {
+            std::lock_guard<std::mutex> lock(target->mutex);
+            target->tasks.push_back(std::move(task));
+            target->unfinished++;
+
+            // another token only if the waiting tokens do not cover the queued tasks
+            schedule = target->tokens < target->concurrency && target->tokens - target->running < target->tasks.size();
+            if (schedule)
+            {
+                target->tokens++;
+            }
+        }
+
+        if (schedule)
+        {
+            _push_token(target);
+        }
+    }
+
+    void frameScheduler::wait(group &target)
+    {
+        std::unique_lock<std::mutex> lock(target.mutex);
+        target.idle.wait(lock, [&]()
+                         { return target.unfinished == 0; });
+    }
+
+    void frameScheduler::_push_token(const std::shared_ptr<group> &token)
+    {
+        const size_t index = current_scheduler == this ? current_worker : _next_worker.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+        {
+            std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+            _workers[index]->tokens.push_back(token);
+        }
+
+        // sleepers announce themselves before checking for tokens; only wake when somebody sleeps
+        _queued_tokens.fetch_add(1);
+        if (_sleeping.load())
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _wake.notify_one();
+        }
+    }
+
+    std::shared_ptr<frameScheduler::group> frameScheduler::_pop_token(size_t index)
+    {
+        for (size_t i = 0; i < _workers.size(); i++)
+        {
+            auto &victim = *_workers[(index + i) % _workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tokens.empty())
+            {
+                continue;
+            }
+
+            std::shared_ptr<group> token;
+            if (i == 0)
+            {
+                token = std::move(victim.tokens.front());
+                victim.tokens.pop_front();
+            }
+            else
+            {
+                token = std::move(victim.tokens.back());
+                victim.tokens.pop_back();
+                _steals.fetch_add(1, std::memory_order_relaxed);
+            }
+            _queued_tokens.fetch_sub(1);
+            return token;
+        }
+        return nullptr;
+    }
+
+    void frameScheduler::_run(const std::shared_ptr<group> &token)
+    {
+        for (unsigned int turn = 0; turn <= token->weight; turn++)
+        {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(token->mutex);
+                if (token->tasks.empty())
+                {
+                    token->tokens--;
+                    return;
+                }
+                if (turn == token->weight)
+                {
+                    // turn used up: requeue behind other cameras
+                    break;
+                }
+                task = std::move(token->tasks.front());
+                token->tasks.pop_front();
+                token->running++;
+            }
+
+            try
+            {
+                task();
+            }
+            catch (const std::exception &e)
+            {
+                PLOG_ERROR << fmt::format("frame scheduler: task of group {} failed: {}", token->name, e.what());
+            }
+            catch (...)
+            {
+                PLOG_ERROR << fmt::format("frame scheduler: task of group {} failed", token->name);
+            }
+            _executed.fetch_add(1, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(token->mutex);
+            token->running--;
+            if (--token->unfinished == 0)
+            {
+                token->idle.notify_all();
+            }
+        }
+
+        _push_token(token);
+    }
+
+    void frameScheduler::_work(size_t index)
+    {
+        current_scheduler = this;
+        current_worker = index;
+
+        while (true)
+        {
+            if (auto token = _pop_token(index))
+            {
+                _run(token);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            if (!_running && _queued_tokens.load() == 0)
+            {
+                break;
+            }
+            _sleeping.fetch_add(1);
+            _wake.wait(lock, [&]()
+                       { return _queued_tokens.load() > 0 || !_running; });
+            _sleeping.fetch_sub(1);
+        }
+    }
+}
@@ -0,0 +1,235 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "frame_tracer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include <plog/Log.h>
+
+namespace uEyeWrapper
+{
+    std::atomic<bool> frameTracer::_enabled = false;
+
+    namespace
+    {
+        // fields are atomic to allow dumping while the owning thread keeps writing; a span overwritten during a dump may be inconsistent
+        struct traceEntry
+        {
+            std::atomic<const char *> name;
+            std::atomic<uint32_t> camera;
+            std::atomic<uint64_t> frame;
+            std::atomic<int64_t> begin;
+            std::atomic<int64_t> end;
+        };
+
+        // single writer ring buffer owned by one thread; kept alive by the registry after the thread exits, until dumped
+        struct traceBuffer
+        {
+            long tid;
+            std::string thread_name;
+            std::atomic<uint64_t> head{0};
+            std::atomic<uint64_t> floor{0}; // spans before floor were cleared
+            std::atomic<bool> exited{false};
+            std::array<traceEntry, FRAME_TRACER_BUFFER_SPANS> entries;
+        };
+
+        // thread local owner; marks the buffer on thread exit
+        struct threadBuffer
+        {
+            std::shared_ptr<traceBuffer> buffer;
+
+            ~threadBuffer()
+            {
+                buffer->exited.store(true, std::memory_order_release);
+            }
+        };
+
+        std::mutex &registry_mutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::vector<std::shared_ptr<traceBuffer>> &registry()
+        {
+            static std::vector<std::shared_ptr<traceBuffer>> buffers;
+            return buffers;
+        }
+
+        // drops the buffers of exited threads but the newest keep; requires registry_mutex()
+        void release_exited(size_t keep)
+        {
+            auto &buffers = registry();
+            size_t exited = 0;
+            for (auto buffer = buffers.rbegin(); buffer != buffers.rend(); buffer++)
+            {
+                if ((*buffer)->exited.load(std::memory_order_acquire) && ++exited > keep)
+                {
+                    (*buffer).reset();
+                }
+            }
+            buffers.erase(std::remove(buffers.begin(), buffers.end(), nullptr), buffers.end());
+        }
+
+        traceBuffer &thread_buffer()
+        {
+            // capture handles start fresh dispatcher and pool threads; bound what they leave behind
+            thread_local threadBuffer owner{[]()
+            {
+                std::lock_guard<std::mutex> lock(registry_mutex());
+                release_exited(FRAME_TRACER_MAX_EXITED_BUFFERS);
+                auto buffer = std::make_shared<traceBuffer>();
+#ifdef __linux__
+                buffer->tid = (long)syscall(SYS_gettid);
+                char name[16] = {0};
+                pthread_getname_np(pthread_self(), name, sizeof(name));
+                buffer->thread_name = name;
+#else
+                buffer->tid = (long)registry().size();
+#endif
+                registry().push_back(buffer);
+                return buffer;
+            }()};
+            return *owner.buffer;
+        }
+
+        std::string escape_json(const std::string &value)
+        {
+            std::string escaped;
+            escaped.reserve(value.size());
+            for (auto c : value)
+            {
+                if (c == '\\' || c == '"')
+                {
+                    escaped.push_back('\\');
+                }
+                if ((unsigned char)c < 0x20)
+                {
+                    escaped += fmt::format("\\u{:04x}", (unsigned int)c);
+                    continue;
+                }
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+
+        // trace event timestamps are microseconds; keep ns resolution without going through double
+        std::string microseconds(int64_t ns)
+        {
+            return fmt::format("{}.{:03}", ns / 1000, ns % 1000);
+        }
+    }
+
+    void frameTracer::record(const char *name, uint32_t camera, uint64_t frame, int64_t begin, int64_t end)
+    {
+        auto &buffer = thread_buffer();
+        const auto head = buffer.head.load(std::memory_order_relaxed);
+        auto &entry = buffer.entries[head % FRAME_TRACER_BUFFER_SPANS];
+        entry.name.store(name, std::memory_order_relaxed);
+        entry.camera.store(camera, std::memory_order_relaxed);
+        entry.frame.store(frame, std::memory_order_relaxed);
+        entry.begin.store(begin, std::memory_order_relaxed);
+        entry.end.store(end, std::memory_order_relaxed);
+        buffer.head.store(head + 1, std::memory_order_release);
+    }
+
+    std::string frameTracer::dumpChromeTrace()
+    {
+        long pid = 0;
+        std::string process_name = "uEye-wrapper";
+#ifdef __linux__
+        pid = (long)getpid();
+        char hostname[256] = {0};
+        if (gethostname(hostname, sizeof(hostname) - 1) == 0)
+        {
+            process_name = fmt::format("uEye-wrapper@{}", hostname);
+        }
+#endif
+
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out += fmt::format("{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"args\":{{\"name\":\"{}\"}}}}", pid, escape_json(process_name));
+
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (auto &buffer : registry())
+        {
+            if (!buffer->thread_name.empty())
+            {
+                out += fmt::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", pid, buffer->tid, escape_json(buffer->thread_name));
+            }
+
+            // exited before reading head: all of its spans are dumped below
+            const bool exited = buffer->exited.load(std::memory_order_acquire);
+            const auto head = buffer->head.load(std::memory_order_acquire);
+            const auto floor = buffer->floor.load(std::memory_order_relaxed);
+            const auto first = std::max(floor, head > FRAME_TRACER_BUFFER_SPANS ? head - FRAME_TRACER_BUFFER_SPANS : 0);
+            for (auto i = first; i < head; i++)
+            {
+                auto &entry = buffer->entries[i % FRAME_TRACER_BUFFER_SPANS];
+                const auto begin = entry.begin.load(std::memory_order_relaxed);
+                const auto end = entry.end.load(std::memory_order_relaxed);
+                const auto args = fmt::format("{{\"camera\":{},\"frame\":{}}}", entry.camera.load(std::memory_order_relaxed), entry.frame.load(std::memory_order_relaxed));
+
+                if (begin == end)
+                {
+                    out += fmt::format(",\n{{\"name\":\"{}\",\"cat\":\"ueye\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{},\"pid\":{},\"tid\":{},\"args\":{}}}",
+                                       entry.name.load(std::memory_order_relaxed), microseconds(begin), pid, buffer->tid, args);
+                }
+                else
+                {
+                    out += fmt::format(",\n{{\"name\":\"{}\",\"cat\":\"ueye\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":{},\"tid\":{},\"args\":{}}}",
+                                       entry.name.load(std::memory_order_relaxed), microseconds(begin), microseconds(end - begin), pid, buffer->tid, args);
+                }
+            }
+
+            if (exited)
+            {
+                buffer.reset();
+            }
+        }
+        registry().erase(std::remove(registry().begin(), registry().end(), nullptr), registry().end());
+
+        out += "\n]}\n";
+        return out;
+    }
+
+    void frameTracer::writeChromeTrace(const std::string &path)
+    {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("frame tracer: failed to open {} for writing", path));
+        }
+        file << dumpChromeTrace();
+        PLOG_INFO << fmt::format("frame tracer: trace written to {}", path);
+    }
+
+    void frameTracer::clear()
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+        for (auto &buffer : registry())
+        {
+            buffer->floor.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+        release_exited(0);
+    }
+}
@@ -0,0 +1,295 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "metrics_exporter.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <tuple>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include <plog/Log.h>
+
+// interval to check for shutdown while waiting for connections
+#define METRICS_EXPORTER_POLL_INTERVAL_MS 250
+#define METRICS_EXPORTER_RECEIVE_TIMEOUT_MS 1000
+
+namespace uEyeWrapper
+{
+    namespace
+    {
+        // fixed exported bucket boundaries in seconds; fine grained histogram buckets are accumulated into these
+        constexpr std::array<double, 19> exported_bounds = {
+            0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005,
+            0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+            0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+
+        std::string escape_label(const std::string &value)
+        {
+            std::string escaped;
+            escaped.reserve(value.size());
+            for (auto c : value)
+            {
+                if (c == '\\' || c == '"')
+                {
+                    escaped.push_back('\\');
+                }
+                if (c == '\n')
+                {
+                    escaped += "\\n";
+                    continue;
+                }
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+
+        std::string camera_labels(const uEyeCameraInfo &camera)
+        {
+            return fmt::format("camera=\"{}\",model=\"{}\",serial=\"{}\"", camera.deviceId, escape_label(camera.modelName), escape_label(camera.serialNo));
+        }
+
+        void render_histogram(std::string &out, const std::string &labels, const std::string &name, const latencyHistogram &histogram)
+        {
+            std::array<uint64_t, exported_bounds.size()> cumulative{};
+            uint64_t total = 0;
+            histogram.for_each_bucket([&](uint64_t upper_ns, uint64_t count)
+                                      {
+                                          total += count;
+                                          for (size_t i = 0; i < exported_bounds.size(); i++)
+                                          {
+                                              if (upper_ns <= exported_bounds[i] * 1e9)
+                                              {
+                                                  cumulative[i] += count;
+                                              }
+                                          } });
+
+            for (size_t i = 0; i < exported_bounds.size(); i++)
+            {
+                out += fmt::format("{}_bucket{{{},le=\"{}\"}} {}\n", name, labels, exported_bounds[i], cumulative[i]);
+            }
+            out += fmt::format("{}_bucket{{{},le=\"+Inf\"}} {}\n", name, labels, total);
+            out += fmt::format("{}_sum{{{}}} {}\n", name, labels, histogram.sum() / 1e9);
+            out += fmt::format("{}_count{{{}}} {}\n", name, labels, total);
+        }
+    }
+
+    metricsExporter::metricsExporter(uint16_t port, std::string address) : _socket(-1), _running(false)
+    {
+#ifdef __linux__
+        _socket = socket(AF_INET, SOCK_STREAM, 0);
+        if (_socket < 0)
+        {
+            throw std::runtime_error("metrics exporter: failed to create socket");
+        }
+
+        int reuse = 1;
+        setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in bind_address{};
+        bind_address.sin_family = AF_INET;
+        bind_address.sin_port = htons(port);
+        if (inet_pton(AF_INET, address.c_str(), &bind_address.sin_addr) != 1 ||
+            bind(_socket, (sockaddr *)&bind_address, sizeof(bind_address)) != 0 ||
+            listen(_socket, 8) != 0)
+        {
+            close(_socket);
+            throw std::runtime_error(fmt::format("metrics exporter: failed to listen on {}:{}", address, port));
+        }
+
+        _running = true;
+        _server = std::thread(&metricsExporter::_serve, this);
+
+        PLOG_INFO << fmt::format("metrics exporter listening on http://{}:{}/metrics", address, port);
+#else
+        throw std::runtime_error("metrics exporter: not supported on this platform");
+#endif
+    }
+
+    metricsExporter::~metricsExporter()
+    {
+        _running = false;
+        if (_server.joinable())
+        {
+            _server.join();
+        }
+#ifdef __linux__
+        if (_socket >= 0)
+        {
+            close(_socket);
+        }
+#endif
+    }
+
+    void metricsExporter::add(const uEyeCameraInfo &camera, const cameraMetrics &metrics)
+    {
+        std::lock_guard<std::mutex> lock(_sources_mutex);
+        _sources.emplace_back(camera, &metrics);
+    }
+
+    void metricsExporter::remove(const cameraMetrics &metrics)
+    {
+        std::lock_guard<std::mutex> lock(_sources_mutex);
+        _sources.erase(
+            std::remove_if(_sources.begin(), _sources.end(), [&](auto &source)
+                           { return source.second == &metrics; }),
+            _sources.end());
+    }
+
+    std::string metricsExporter::render() const
+    {
+        std::lock_guard<std::mutex> lock(_sources_mutex);
+        std::string out;
+
+        // metric families have to be grouped; emit one family at a time for all cameras
+        out += "# HELP ueye_frames_total Frames received by the image dispatcher\n# TYPE ueye_frames_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_frames_total{{{}}} {}\n", camera_labels(camera), metrics->frames.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_callback_errors_total Image callbacks terminated by an exception\n# TYPE ueye_callback_errors_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_callback_errors_total{{{}}} {}\n", camera_labels(camera), metrics->callbackErrors.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_dropped_frames_total Frames released without reaching a consumer\n# TYPE ueye_dropped_frames_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_dropped_frames_total{{{}}} {}\n", camera_labels(camera), metrics->droppedFrames.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_expired_frames_total Frames skipped for exceeding the maximum age before their callback started\n# TYPE ueye_expired_frames_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_expired_frames_total{{{}}} {}\n", camera_labels(camera), metrics->expiredFrames.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_device_missed_frames_total Frames the camera did not deliver, from device timestamp gaps and DEV_MISSED_IMAGES\n# TYPE ueye_device_missed_frames_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_device_missed_frames_total{{{}}} {}\n", camera_labels(camera), metrics->deviceMissedFrames.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_driver_skipped_frames_total Frames received by the driver but skipped by the image dispatcher, from frame number gaps\n# TYPE ueye_driver_skipped_frames_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_driver_skipped_frames_total{{{}}} {}\n", camera_labels(camera), metrics->driverSkippedFrames.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_sequence_growths_total Image buffer sequence grown at runtime\n# TYPE ueye_sequence_growths_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_sequence_growths_total{{{}}} {}\n", camera_labels(camera), metrics->sequenceGrowths.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_sequence_shrinks_total Image buffer sequence shrunk at runtime\n# TYPE ueye_sequence_shrinks_total counter\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_sequence_shrinks_total{{{}}} {}\n", camera_labels(camera), metrics->sequenceShrinks.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_fps Smoothed frame rate at the image dispatcher\n# TYPE ueye_fps gauge\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_fps{{{}}} {}\n", camera_labels(camera), metrics->fps());
+        }
+        out += "# HELP ueye_queue_depth Frames waiting for a pool worker\n# TYPE ueye_queue_depth gauge\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_queue_depth{{{}}} {}\n", camera_labels(camera), metrics->queueDepth.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_locked_buffers Sequence buffers locked by the wrapper\n# TYPE ueye_locked_buffers gauge\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_locked_buffers{{{}}} {}\n", camera_labels(camera), metrics->lockedBuffers.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_sequence_buffers Image buffers in the sequence\n# TYPE ueye_sequence_buffers gauge\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_sequence_buffers{{{}}} {}\n", camera_labels(camera), metrics->sequenceBuffers.load(std::memory_order_relaxed));
+        }
+        out += "# HELP ueye_sequence_bytes Image memory allocated for the sequence\n# TYPE ueye_sequence_bytes gauge\n";
+        for (auto &[camera, metrics] : _sources)
+        {
+            out += fmt::format("ueye_sequence_bytes{{{}}} {}\n", camera_labels(camera), metrics->sequenceBytes.load(std::memory_order_relaxed));
+        }
+
+        const std::array<std::tuple<const char *, const char *, const latencyHistogram cameraMetrics::*>, 3> histograms = {{
+            {"ueye_device_to_wakeup_seconds", "Driver frame timestamp to dispatcher wakeup", &cameraMetrics::deviceToWakeup},
+            {"ueye_wakeup_to_task_start_seconds", "Dispatcher wakeup to callback task start", &cameraMetrics::wakeupToTaskStart},
+            {"ueye_callback_duration_seconds", "Image callback runtime", &cameraMetrics::callbackDuration},
+        }};
+        for (auto &[name, help, member] : histograms)
+        {
+            out += fmt::format("# HELP {} {}\n# TYPE {} histogram\n", name, help, name);
+            for (auto &[camera, metrics] : _sources)
+            {
+                render_histogram(out, camera_labels(camera), name, (*metrics).*member);
+            }
+        }
+
+        return out;
+    }
+
+    void metricsExporter::_serve()
+    {
+#ifdef __linux__
+        while (_running)
+        {
+            pollfd listening = {_socket, POLLIN, 0};
+            if (poll(&listening, 1, METRICS_EXPORTER_POLL_INTERVAL_MS) <= 0)
+            {
+                continue;
+            }
+
+            int connection = accept(_socket, nullptr, nullptr);
+            if (connection < 0)
+            {
+                continue;
+            }
+
+            // the request is not interpreted; wait for the request head to not reset the connection on close
+            timeval timeout = {METRICS_EXPORTER_RECEIVE_TIMEOUT_MS / 1000, (METRICS_EXPORTER_RECEIVE_TIMEOUT_MS % 1000) * 1000};
+            setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            std::array<char, 4096> request;
+            recv(connection, request.data(), request.size(), 0);
+
+            try
+            {
+                const std::string body = render();
+                const std::string response = fmt::format(
+                    "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: {}\r\nConnection: close\r\n\r\n{}",
+                    body.size(),
+                    body);
+
+                size_t sent = 0;
+                while (sent < response.size())
+                {
+                    auto n = send(connection, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                    if (n <= 0)
+                    {
+                        break;
+                    }
+                    sent += (size_t)n;
+                }
+            }
+            catch (const std::exception &e)
+            {
+                PLOG_ERROR << fmt::format("metrics exporter failed to render metrics: {}", e.what());
+            }
+
+            close(connection);
+        }
+#endif
+    }
+}
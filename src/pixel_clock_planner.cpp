@@ -0,0 +1,178 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "pixel_clock_planner.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace uEyeWrapper
+{
+    pixelClockPlanner::pixelClockPlanner(std::vector<UINT> clocks, UINT current_clock, fpsRange current_fps) : _clocks(clocks),
+                                                                                                             _current_clock(current_clock),
+                                                                                                             _current_fps(current_fps)
+    {
+        std::sort(_clocks.begin(), _clocks.end());
+        _clocks.erase(std::unique(_clocks.begin(), _clocks.end()), _clocks.end());
+    }
+
+    pixelClockPlan pixelClockPlanner::plan(double FPS, pixelClockObjective objective, const probeT &probe) const
+    {
+        if (_clocks.empty())
+        {
+            return {_current_clock, _current_fps, _current_fps.contains(FPS), 0};
+        }
+        return objective == pixelClockObjective::minimalLatency ? _plan_latency(FPS, probe) : _plan_bandwidth(FPS, probe);
+    }
+
+    pixelClockPlan pixelClockPlanner::_plan_bandwidth(double FPS, const probeT &probe) const
+    {
+        pixelClockPlan result = {_current_clock, _current_fps, _current_fps.contains(FPS), 0};
+        if (result.feasible)
+        {
+            return result;
+        }
+
+        UINT probed = _current_clock;
+        auto probe_clock = [&](UINT clock)
+        {
+            result.probes++;
+            probed = clock;
+            return probe(clock);
+        };
+
+        // both ends of the FPS range do not decrease with the clock: a maximum below the request takes a higher clock,
+        // a minimum above it a lower one, at most the current clock
+        // search the lowest candidate with sufficient maximum in [low, high); high == candidates.size() while none is known
+        const bool raise = _current_fps.max < FPS;
+        std::vector<UINT> candidates;
+        if (raise)
+        {
+            candidates.assign(std::upper_bound(_clocks.begin(), _clocks.end(), _current_clock), _clocks.end());
+        }
+        else
+        {
+            candidates.assign(_clocks.begin(), std::lower_bound(_clocks.begin(), _clocks.end(), _current_clock));
+            candidates.push_back(_current_clock);
+        }
+        if (candidates.empty())
+        {
+            return result;
+        }
+        std::vector<fpsRange> ranges(candidates.size(), {0, 0});
+        size_t low = 0, high = candidates.size();
+        if (!raise)
+        {
+            high = candidates.size() - 1;
+            ranges[high] = _current_fps;
+        }
+
+        double fps_per_clock = _current_clock > 0 ? _current_fps.max / _current_clock : 0;
+        bool bisect = fps_per_clock <= 0;
+        while (low < high)
+        {
+            size_t guess = low + (high - low) / 2;
+            if (!bisect)
+            {
+                const double estimate = std::ceil(FPS / fps_per_clock);
+                guess = std::lower_bound(candidates.begin(), candidates.end(), estimate) - candidates.begin();
+                guess = std::clamp(guess, low, high - 1);
+            }
+
+            const size_t remaining = high - low;
+            ranges[guess] = probe_clock(candidates[guess]);
+            if (ranges[guess].max >= FPS)
+            {
+                high = guess;
+            }
+            else
+            {
+                low = guess + 1;
+            }
+
+            // recalibrate on the probe; bisect next if the model did not halve the remaining candidates
+            if (ranges[guess].max > 0)
+            {
+                fps_per_clock = ranges[guess].max / candidates[guess];
+            }
+            bisect = fps_per_clock <= 0 || (high - low) > remaining / 2;
+        }
+
+        // none sufficient: highest clock gets closest
+        const size_t selected = high < candidates.size() ? high : candidates.size() - 1;
+        result.clock = candidates[selected];
+        result.FPS = probed == result.clock ? ranges[selected] : probe_clock(result.clock);
+        result.feasible = result.FPS.contains(FPS);
+        return result;
+    }
+
+    pixelClockPlan pixelClockPlanner::_plan_latency(double FPS, const probeT &probe) const
+    {
+        pixelClockPlan result = {_current_clock, _current_fps, false, 0};
+
+        UINT probed = _current_clock;
+        auto probe_clock = [&](UINT clock)
+        {
+            result.probes++;
+            probed = clock;
+            return probe(clock);
+        };
+
+        // readout time only depends on the clock: take the highest one whose minimum FPS allows the request
+        // search it in [low, high); clocks from high on have a higher minimum
+        const size_t none = _clocks.size();
+        std::vector<fpsRange> ranges(_clocks.size(), {0, 0});
+        size_t low = 0, high = _clocks.size(), selected = none;
+
+        const auto current = std::lower_bound(_clocks.begin(), _clocks.end(), _current_clock);
+        if (current != _clocks.end() && *current == _current_clock)
+        {
+            const size_t index = current - _clocks.begin();
+            ranges[index] = _current_fps;
+            if (_current_fps.min <= FPS)
+            {
+                selected = index;
+                low = index + 1;
+            }
+            else
+            {
+                high = index;
+            }
+        }
+
+        // the highest clock first; usually its minimum is low enough
+        bool highest = true;
+        while (low < high)
+        {
+            const size_t guess = highest ? high - 1 : low + (high - low) / 2;
+            highest = false;
+
+            ranges[guess] = probe_clock(_clocks[guess]);
+            if (ranges[guess].min <= FPS)
+            {
+                selected = guess;
+                low = guess + 1;
+            }
+            else
+            {
+                high = guess;
+            }
+        }
+
+        // every minimum too high: the lowest clock gets closest
+        if (selected == none)
+        {
+            selected = 0;
+        }
+        result.clock = _clocks[selected];
+        result.FPS = probed == result.clock ? ranges[selected] : probe_clock(result.clock);
+        // a lower clock does not raise the maximum
+        result.feasible = result.FPS.contains(FPS);
+        return result;
+    }
+}
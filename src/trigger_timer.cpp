@@ -0,0 +1,214 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (C) 2020, Arne Wendt
+ *
+ * */
+
+#include "trigger_timer.h"
+#include "thread_helpers.h"
+using namespace std::chrono_literals;
+
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#endif
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <plog/Log.h>
+
+namespace uEyeWrapper
+{
+    namespace
+    {
+        std::atomic<size_t> next_task_id{1};
+    }
+
+    triggerTimer::triggerTimer(std::vector<int> cpus, int priority, std::chrono::nanoseconds spin) : _spin(spin),
+                                                                                                   _running_task(0),
+                                                                                                   _cancel_running(false),
+                                                                                                   _stop(false),
+                                                                                                   _fired(0),
+                                                                                                   _missed(0)
+    {
+        _executor = std::thread(&triggerTimer::_run, this);
+
+        auto executor = _executor.native_handle();
+        set_thread_name(executor, "ueye-trg");
+        if (!set_thread_affinity(executor, cpus))
+        {
+            PLOG_WARNING << fmt::format("trigger timer: failed pinning to cpus {}", cpus);
+        }
+        if (!set_thread_fifo_priority(executor, priority))
+        {
+            PLOG_WARNING << fmt::format("trigger timer: failed setting SCHED_FIFO priority {}; missing CAP_SYS_NICE/RLIMIT_RTPRIO?", priority);
+        }
+
+        PLOG_INFO << fmt::format("trigger timer running (cpus {}, priority {}, spin {}us)",
+                                 cpus,
+                                 priority,
+                                 std::chrono::duration_cast<std::chrono::microseconds>(spin).count());
+    }
+
+    triggerTimer::~triggerTimer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _changed.notify_all();
+        if (_executor.joinable())
+        {
+            _executor.join();
+        }
+    }
+
+    triggerTimer &triggerTimer::global()
+    {
+        static triggerTimer timer;
+        return timer;
+    }
+
+    size_t triggerTimer::at(clock::time_point target, std::function<void()> run)
+    {
+        return _add(target, std::chrono::nanoseconds(0), std::move(run));
+    }
+
+    size_t triggerTimer::every(clock::time_point first, std::chrono::nanoseconds period, std::function<void()> run)
+    {
+        if (period <= std::chrono::nanoseconds(0))
+        {
+            throw std::logic_error("trigger timer: period has to be positive");
+        }
+        return _add(first, period, std::move(run));
+    }
+
+    size_t triggerTimer::_add(clock::time_point target, std::chrono::nanoseconds period, std::function<void()> run)
+    {
+        const size_t id = next_task_id.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace(target, task{id, period, std::move(run)});
+        }
+        _changed.notify_all();
+        return id;
+    }
+
+    void triggerTimer::cancel(size_t id)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (auto it = _tasks.begin(); it != _tasks.end(); it++)
+        {
+            if (it->second.id == id)
+            {
+                _tasks.erase(it);
+                _changed.notify_all();
+                break;
+            }
+        }
+
+        if (_running_task == id)
+        {
+            // not rescheduled when periodic
+            _cancel_running = true;
+            if (std::this_thread::get_id() != _executor.get_id())
+            {
+                _changed.wait(lock, [&]()
+                              { return _running_task != id; });
+            }
+        }
+    }
+
+    void triggerTimer::_sleep_until(clock::time_point target)
+    {
+        const auto wake = target - _spin;
+        if (clock::now() < wake)
+        {
+#ifdef __linux__
+            // system_clock is CLOCK_REALTIME; an absolute sleep follows clock adjustments
+            const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wake.time_since_epoch()).count();
+            const timespec until = {(time_t)(since_epoch / 1000000000), (long)(since_epoch % 1000000000)};
+            while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &until, nullptr) == EINTR)
+            {
+            }
+#else
+            std::this_thread::sleep_until(wake);
+#endif
+            _oversleep.record(clock::now() - wake);
+        }
+
+        while (clock::now() < target)
+        {
+        }
+    }
+
+    void triggerTimer::_run()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop)
+        {
+            if (_tasks.empty())
+            {
+                _changed.wait(lock);
+                continue;
+            }
+
+            // coarse wait stays responsive to new and cancelled tasks
+            const auto target = _tasks.begin()->first;
+            if (target - clock::now() > TRIGGER_TIMER_COARSE_MARGIN)
+            {
+                _changed.wait_until(lock, target - TRIGGER_TIMER_COARSE_MARGIN);
+                continue;
+            }
+
+            lock.unlock();
+            _sleep_until(target);
+            lock.lock();
+
+            // run everything due, the awaited task may have been cancelled meanwhile
+            while (!_stop && !_tasks.empty() && _tasks.begin()->first <= clock::now())
+            {
+                auto due = _tasks.begin();
+                const auto due_target = due->first;
+                task current = std::move(due->second);
+                _tasks.erase(due);
+                _running_task = current.id;
+                _cancel_running = false;
+                lock.unlock();
+
+                _lateness.record(clock::now() - due_target);
+                try
+                {
+                    current.run();
+                }
+                catch (const std::exception &e)
+                {
+                    PLOG_ERROR << fmt::format("trigger timer: task {} failed: {}", current.id, e.what());
+                }
+                _fired.fetch_add(1, std::memory_order_relaxed);
+
+                lock.lock();
+                _running_task = 0;
+                if (current.period.count() && !_cancel_running)
+                {
+                    auto next = std::chrono::time_point_cast<clock::duration>(due_target + current.period);
+                    const auto now = clock::now();
+                    if (next <= now)
+                    {
+                        const auto behind = (now - next) / current.period + 1;
+                        _missed.fetch_add((uint64_t)behind, std::memory_order_relaxed);
+                        next = std::chrono::time_point_cast<clock::duration>(next + behind * current.period);
+                    }
+                    _tasks.emplace(next, std::move(current));
+                }
+                // cancel() waits for the running task
+                _changed.notify_all();
+            }
+        }
+    }
+}
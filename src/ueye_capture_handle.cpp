@@ -1,4 +1,5 @@
 #include "ueye_capture_handle.h"
+#include "ueye_wrapper.h"
 using namespace std::chrono_literals;
 #include <ctime>
 #include <iomanip>
@@ -11,6 +12,9 @@ using namespace std::chrono_literals;
 
 #include <plog/Log.h>
 
+#include <mutex>
+#include <condition_variable>
+
 namespace uEyeWrapper
 {
     // call api methods, log info, throw on error and perform cleanup
@@ -18,22 +22,27 @@ namespace uEyeWrapper
     template <typename H, captureType C>
     UEYE_API_CALL_MEMBER_DEF(uEyeCaptureHandle<H, C>)
     {
-        auto _msg = msg;
-        const std::string common_prefix = fmt::format(
-            "[{}@{}] capture handle {{camera {} ({} [#{}])}}",
-            caller_name,
-            caller_line,
-            _camera_handle.camera.deviceId,
-            _camera_handle.camera.modelName,
-            _camera_handle.camera.serialNo);
+        // the prefix is only formatted on failure or with debug logging enabled
+        auto common_prefix = [&]()
+        {
+            return fmt::format(
+                "[{}@{}] capture handle {{camera {} ({} [#{}])}}",
+                caller_name,
+                caller_line,
+                _camera_handle.camera.deviceId,
+                _camera_handle.camera.modelName,
+                _camera_handle.camera.serialNo);
+        };
 
         int nret = std::apply(f, f_args);
         if (nret != IS_SUCCESS)
         {
+            std::string _msg(msg);
+
             // query API for error message if user supplied message is empty and return code is IS_NO_SUCCESS
             if (_msg.length() == 0 && nret == IS_NO_SUCCESS)
             {
-                PLOG_DEBUG << fmt::format("{}: querying API for error message", common_prefix);
+                PLOG_DEBUG << fmt::format("{}: querying API for error message", common_prefix());
                 auto err_info = _camera_handle._get_last_error_msg();
                 _msg = std::get<1>(err_info);
             }
@@ -46,13 +55,13 @@ namespace uEyeWrapper
                 nret);
 
             // log the error as warning from wrapper; error handling shall be done by user
-            PLOG_WARNING << fmt::format("{}: {}", common_prefix, common_msg);
+            PLOG_WARNING << fmt::format("{}: {}", common_prefix(), common_msg);
 
             // if a cleanup is required and a handler function is provided, execute it
-            if (cleanup_handler)
+            if constexpr (!std::is_null_pointer_v<std::decay_t<CleanupT>>)
             {
-                PLOG_WARNING << fmt::format("{}: calling provided cleanup handler after failed call to {}()", common_prefix, f_name);
-                cleanup_handler();
+                PLOG_WARNING << fmt::format("{}: calling provided cleanup handler after failed call to {}()", common_prefix(), f_name);
+                _api_cleanup(std::forward<CleanupT>(cleanup_handler));
             }
 
             // throw error
@@ -60,54 +69,371 @@ namespace uEyeWrapper
         }
 
         // log API method name and return code for debugging purposes (nret will allways be IS_SUCCESS(0) here)
-        PLOG_DEBUG << fmt::format("{}: {}() returned with code {}", common_prefix, f_name, nret);
+        PLOG_DEBUG << fmt::format("{}: {}() returned with code {}", common_prefix(), f_name, nret);
     }
 
     template <typename H, captureType C>
-    uEyeCaptureHandle<H, C>::uEyeCaptureHandle(const H &camera_handle, imageCallbackT imageCallback) : _camera_handle(camera_handle),
+    uEyeCaptureHandle<H, C>::uEyeCaptureHandle(const H &camera_handle, imageCallbackT imageCallback, std::vector<subscriberCallbackT> subscribers) : metrics(camera_handle._metrics),
+                                                                                                       _camera_handle(camera_handle),
                                                                                                        imageCallback(imageCallback),
-                                                                                                       _pool((unsigned int)camera_handle._concurrency)
+                                                                                                       _pull(!imageCallback && subscribers.empty()),
+                                                                                                       _batch_generation(0),
+                                                                                                       _batch_closed(false),
+                                                                                                       _next_subscriber(0),
+                                                                                                       _mode(C == captureType::SESSION ? captureType::TRIGGER : C),
+                                                                                                       _paused(false),
+                                                                                                       _live_active(false),
+                                                                                                       _frame_settings_generation(0),
+                                                                                                       _capturing(false),
+                                                                                                       _pool(_pull || camera_handle._reactor || camera_handle._scheduler ? nullptr : std::make_unique<BS::thread_pool>((unsigned int)camera_handle._concurrency)),
+                                                                                                       _executor(_pull || camera_handle._scheduler ? nullptr : camera_handle._reactor ? &camera_handle._reactor->pool() : _pool.get()),
+                                                                                                       _scheduler_group(!_pull && camera_handle._scheduler ? camera_handle._scheduler->addGroup(camera_handle._scheduling_policy, fmt::format("camera {}", camera_handle.camera.deviceId)) : nullptr),
+                                                                                                       _max_frame_age(std::chrono::microseconds(0)),
+                                                                                                       _newest_first(false),
+                                                                                                       _callbacks_in_flight(0),
+                                                                                                       _frames_closed(false),
+                                                                                                       _frame_log_limiter(frameLogInterval),
+                                                                                                       _gap_detector(C == captureType::LIVE, camera_handle._error_stats.DEV_MISSED_IMAGES.count()),
+                                                                                                       _gap_detector_restart(false)
+    {
+        for (auto &subscriber : subscribers)
+        {
+            subscribe(std::move(subscriber));
+        }
+
+        _start();
+    }
+
+    namespace
+    {
+        // leave the driver at least one free sequence buffer while a batch is collected
+        batchPolicy bounded_batch_policy(batchPolicy policy, size_t buffers)
+        {
+            policy.maxFrames = std::clamp<size_t>(policy.maxFrames, 1, std::max<size_t>(buffers, 2) - 1);
+            return policy;
+        }
+    }
+
+    template <typename H, captureType C>
+    uEyeCaptureHandle<H, C>::uEyeCaptureHandle(const H &camera_handle, batchCallbackT batchCallback, batchPolicy policy) : metrics(camera_handle._metrics),
+                                                                                                          _camera_handle(camera_handle),
+                                                                                                          imageCallback(nullptr),
+                                                                                                          _pull(false),
+                                                                                                          _batch_callback(std::move(batchCallback)),
+                                                                                                          _batch_policy(bounded_batch_policy(policy, camera_handle._memory_manager.buffers())),
+                                                                                                          _batch_generation(0),
+                                                                                                          _batch_closed(false),
+                                                                                                          _next_subscriber(0),
+                                                                                                          _mode(C == captureType::SESSION ? captureType::TRIGGER : C),
+                                                                                                          _paused(false),
+                                                                                                          _live_active(false),
+                                                                                                          _frame_settings_generation(0),
+                                                                                                          _capturing(false),
+                                                                                                          _pool(camera_handle._reactor || camera_handle._scheduler ? nullptr : std::make_unique<BS::thread_pool>((unsigned int)camera_handle._concurrency)),
+                                                                                                          _executor(camera_handle._scheduler ? nullptr : camera_handle._reactor ? &camera_handle._reactor->pool() : _pool.get()),
+                                                                                                          _scheduler_group(camera_handle._scheduler ? camera_handle._scheduler->addGroup(camera_handle._scheduling_policy, fmt::format("camera {}", camera_handle.camera.deviceId)) : nullptr),
+                                                                                                          _max_frame_age(std::chrono::microseconds(0)),
+                                                                                                          _newest_first(false),
+                                                                                                          _callbacks_in_flight(0),
+                                                                                                          _frames_closed(false),
+                                                                                                          _frame_log_limiter(frameLogInterval),
+                                                                                                          _gap_detector(C == captureType::LIVE, camera_handle._error_stats.DEV_MISSED_IMAGES.count()),
+                                                                                                          _gap_detector_restart(false)
     {
-        _SPAWN_image_dispatcher();
+        if (!_batch_callback)
+        {
+            throw std::logic_error("capture handle in batch mode requires a batch callback");
+        }
+        if (_batch_policy.maxFrames != policy.maxFrames)
+        {
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} batch size {} exceeds the free sequence buffers; limited to {}",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo,
+                                        policy.maxFrames,
+                                        _batch_policy.maxFrames);
+        }
+
+        _SPAWN_batch_flusher();
+        _start();
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_start()
+    {
+        if (_camera_handle._reactor)
+        {
+            _reactor_registration = _camera_handle._reactor->add(_camera_handle.handle, IS_SET_EVENT_FRAME, [this]()
+                                                                 { _handle_frame_event(); });
+        }
+        else
+        {
+            _SPAWN_image_dispatcher();
+            _apply_thread_placement();
+        }
 
-        PLOG_INFO << fmt::format("capture handle {{camera {} ({} [#{}])}} image dispatcher running; using pool with {} threads for callback execution", // timestamp will be formated without milliseconds by default
+        const std::string executor = _pull             ? std::string("pull mode; frames are queued until taken")
+                                     : _scheduler_group ? fmt::format("using shared scheduler with {} threads for callback execution", _camera_handle._scheduler->workerCount())
+                                                        : fmt::format("using pool with {} threads for callback execution", _executor->get_thread_count());
+        const std::string batching = _batch_callback ? fmt::format("; batches of up to {} frames within {}us", _batch_policy.maxFrames, _batch_policy.maxWait.count()) : "";
+        PLOG_INFO << fmt::format("capture handle {{camera {} ({} [#{}])}} image dispatcher running{}; {}{}",
                                  _camera_handle.camera.deviceId,
                                  _camera_handle.camera.modelName,
                                  _camera_handle.camera.serialNo,
-                                 _pool.get_thread_count());
+                                 _camera_handle._reactor ? " on shared reactor" : "",
+                                 executor,
+                                 batching);
 
         _start_capture();
     }
 
     template <typename H, captureType C>
     template <typename enable_SFINAE>
-    typename std::enable_if_t<C == captureType::TRIGGER, enable_SFINAE>
+    typename std::enable_if_t<C != captureType::LIVE, enable_SFINAE>
     uEyeCaptureHandle<H, C>::trigger(bool wait)
     // void uEyeCaptureHandle<H, C>::trigger()
     {
         /////////////////////////////////////////////////////////////
         // compile time method hiding test
         static_assert(
-            C == captureType::TRIGGER,
+            C != captureType::LIVE,
             "uEyeCaptureHandle::trigger() method being compiled for captureType::LIVE - our SFINAE method hiding broke!");
         /////////////////////////////////////////////////////////////
         // impl
 
+        if (_paused.load(std::memory_order_relaxed))
+        {
+            throw std::logic_error("capture handle is paused");
+        }
+        if (_mode.load(std::memory_order_relaxed) != captureType::TRIGGER)
+        {
+            throw std::logic_error("capture session is in LIVE mode");
+        }
+        // not while the sequence is rebuilt
+        {
+            auto sequence_lock = _camera_handle._memory_manager.share();
+            _camera_handle._memory_manager.triggered();
+        }
         UEYE_API_CALL(is_FreezeVideo, {_camera_handle.handle, wait ? IS_WAIT : IS_DONT_WAIT});
     }
 
+    template <typename H, captureType C>
+    template <typename enable_SFINAE>
+    typename std::enable_if_t<C != captureType::LIVE, enable_SFINAE>
+    uEyeCaptureHandle<H, C>::triggerAt(std::chrono::system_clock::time_point target, triggerTimer &timer)
+    {
+        static_assert(
+            C != captureType::LIVE,
+            "uEyeCaptureHandle::triggerAt() method being compiled for captureType::LIVE - our SFINAE method hiding broke!");
+
+        return _schedule_trigger(timer, target, std::chrono::nanoseconds(0));
+    }
+
+    template <typename H, captureType C>
+    template <typename enable_SFINAE>
+    typename std::enable_if_t<C != captureType::LIVE, enable_SFINAE>
+    uEyeCaptureHandle<H, C>::triggerEvery(std::chrono::system_clock::time_point first, std::chrono::nanoseconds period, triggerTimer &timer)
+    {
+        static_assert(
+            C != captureType::LIVE,
+            "uEyeCaptureHandle::triggerEvery() method being compiled for captureType::LIVE - our SFINAE method hiding broke!");
+
+        if (period <= std::chrono::nanoseconds(0))
+        {
+            throw std::logic_error("trigger period has to be positive");
+        }
+        return _schedule_trigger(timer, first, period);
+    }
+
+    template <typename H, captureType C>
+    size_t uEyeCaptureHandle<H, C>::_schedule_trigger(triggerTimer &timer, std::chrono::system_clock::time_point first, std::chrono::nanoseconds period)
+    {
+        // the id is assigned before the task can look it up, it waits for the lock
+        auto id = std::make_shared<size_t>(0);
+        const bool once = period.count() == 0;
+        auto fire = [this, id, once]()
+        {
+            // runs on the timer thread; no exceptions, the call is not retried
+            const bool armed = !_paused.load(std::memory_order_relaxed) && _mode.load(std::memory_order_relaxed) == captureType::TRIGGER;
+            if (armed)
+            {
+                auto sequence_lock = _camera_handle._memory_manager.share();
+                _camera_handle._memory_manager.triggered();
+            }
+            const INT nret = armed ? is_FreezeVideo(_camera_handle.handle, IS_DONT_WAIT) : IS_SUCCESS;
+            if (nret != IS_SUCCESS)
+            {
+                PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} scheduled trigger failed; is_FreezeVideo() returned with code {}",
+                                            _camera_handle.camera.deviceId,
+                                            _camera_handle.camera.modelName,
+                                            _camera_handle.camera.serialNo,
+                                            nret);
+            }
+
+            if (once)
+            {
+                std::lock_guard<std::mutex> lock(_timed_triggers_mutex);
+                _timed_triggers.erase(std::remove_if(_timed_triggers.begin(), _timed_triggers.end(), [&](const auto &trigger)
+                                                     { return trigger.second == *id; }),
+                                      _timed_triggers.end());
+            }
+        };
+
+        std::lock_guard<std::mutex> lock(_timed_triggers_mutex);
+        *id = once ? timer.at(first, std::move(fire)) : timer.every(first, period, std::move(fire));
+        _timed_triggers.emplace_back(&timer, *id);
+        return *id;
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::cancelTrigger(size_t id)
+    {
+        triggerTimer *timer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_timed_triggers_mutex);
+            auto trigger = std::find_if(_timed_triggers.begin(), _timed_triggers.end(), [&](const auto &trigger)
+                                        { return trigger.second == id; });
+            if (trigger == _timed_triggers.end())
+            {
+                return;
+            }
+            timer = trigger->first;
+            _timed_triggers.erase(trigger);
+        }
+        // without the lock: waits for a running trigger, which may lock it
+        timer->cancel(id);
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_cancel_triggers()
+    {
+        std::vector<std::pair<triggerTimer *, size_t>> pending;
+        {
+            std::lock_guard<std::mutex> lock(_timed_triggers_mutex);
+            pending.swap(_timed_triggers);
+        }
+        for (auto &[timer, id] : pending)
+        {
+            timer->cancel(id);
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::pause()
+    {
+        std::lock_guard<std::mutex> lock(_capture_mutex);
+        if (_paused.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        _paused.store(true, std::memory_order_relaxed);
+        _stop_capture();
+        _gap_detector_restart.store(true, std::memory_order_relaxed);
+
+        PLOG_INFO << fmt::format("capture handle {{camera {} ({} [#{}])}} paused",
+                                 _camera_handle.camera.deviceId,
+                                 _camera_handle.camera.modelName,
+                                 _camera_handle.camera.serialNo);
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::resume()
+    {
+        std::lock_guard<std::mutex> lock(_capture_mutex);
+        if (!_paused.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        _start_capture();
+        _paused.store(false, std::memory_order_relaxed);
+
+        PLOG_INFO << fmt::format("capture handle {{camera {} ({} [#{}])}} resumed",
+                                 _camera_handle.camera.deviceId,
+                                 _camera_handle.camera.modelName,
+                                 _camera_handle.camera.serialNo);
+    }
+
+    template <typename H, captureType C>
+    bool uEyeCaptureHandle<H, C>::paused() const
+    {
+        return _paused.load(std::memory_order_relaxed);
+    }
+
+    template <typename H, captureType C>
+    template <typename enable_SFINAE>
+    typename std::enable_if_t<C == captureType::SESSION, enable_SFINAE>
+    uEyeCaptureHandle<H, C>::setCaptureType(captureType mode)
+    {
+        static_assert(
+            C == captureType::SESSION,
+            "uEyeCaptureHandle::setCaptureType() method being compiled for a fixed capture type - our SFINAE method hiding broke!");
+
+        if (mode == captureType::SESSION)
+        {
+            throw std::logic_error("capture session can only switch to TRIGGER or LIVE");
+        }
+
+        std::lock_guard<std::mutex> lock(_capture_mutex);
+        if (mode == _mode.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        // dispatcher, pool, subscribers and buffers stay; only the driver's acquisition mode changes
+        const auto begin = std::chrono::steady_clock::now();
+        const bool capturing = !_paused.load(std::memory_order_relaxed);
+        if (capturing)
+        {
+            _stop_capture();
+        }
+        _mode.store(mode, std::memory_order_relaxed);
+        _gap_detector_restart.store(true, std::memory_order_relaxed);
+        if (capturing)
+        {
+            _start_capture();
+        }
+
+        PLOG_INFO << fmt::format("capture handle {{camera {} ({} [#{}])}} switched to {} capture{} in {}us",
+                                 _camera_handle.camera.deviceId,
+                                 _camera_handle.camera.modelName,
+                                 _camera_handle.camera.serialNo,
+                                 mode == captureType::LIVE ? "live" : "triggered",
+                                 capturing ? "" : " (paused)",
+                                 std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+    }
+
+    template <typename H, captureType C>
+    captureType uEyeCaptureHandle<H, C>::mode() const
+    {
+        return _mode.load(std::memory_order_relaxed);
+    }
+
     template <typename H, captureType C>
     void uEyeCaptureHandle<H, C>::_start_capture()
     {
         UEYE_API_CALL(is_SetExternalTrigger, {_camera_handle.handle, IS_SET_TRIGGER_SOFTWARE});
 
-        switch (C)
+        switch (_mode.load())
         {
         case captureType::TRIGGER:
+            // triggers register their frames with the memory manager one by one
             break;
         case captureType::LIVE:
+        {
+            if (!_capturing.exchange(true))
+            {
+                _camera_handle._memory_manager.capturing(true);
+            }
+
+            // not while setFPS() changes the pixel clock
+            auto settings_lock = _camera_handle._settings_write_lock();
+            _camera_handle._live_capture(true);
+            _live_active.store(true, std::memory_order_relaxed);
             UEYE_API_CALL(is_CaptureVideo, {_camera_handle.handle, IS_DONT_WAIT});
             break;
+        }
         default:
             throw std::logic_error("unknown capture mode"); // should only ever be evaluated if values modified by debugger!?
         }
@@ -141,115 +467,7 @@ namespace uEyeWrapper
 
                 if ((IS_SUCCESS == ret) && (IS_SET_EVENT_FRAME == wait_events.nSignaled))
                 {
-                    PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image dispatcher GOT IMAGE/FRAME",
-                                              _camera_handle.camera.deviceId,
-                                              _camera_handle.camera.modelName,
-                                              _camera_handle.camera.serialNo);
-                    try
-                    {
-                        // get buffer for last captured image
-                        INT _seqBuffNum;
-                        char *_currMemPtr;
-                        char *imgMemPtr;
-                        UEYE_API_CALL(is_GetActSeqBuf, {_camera_handle.handle, &_seqBuffNum, &_currMemPtr, &imgMemPtr});
-
-                        INT imgMemID = _camera_handle._memory_manager.getID(imgMemPtr);
-
-                        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image in buffer {}[@{}]",
-                                                  _camera_handle.camera.deviceId,
-                                                  _camera_handle.camera.modelName,
-                                                  _camera_handle.camera.serialNo,
-                                                  imgMemID,
-                                                  fmt::ptr(imgMemPtr));
-
-                        // lock buffer
-                        UEYE_API_CALL(is_LockSeqBuf, {_camera_handle.handle, IS_IGNORE_PARAMETER, imgMemPtr});
-
-                        // query image info and build timestamp
-                        UEYEIMAGEINFO imgInfo;
-                        UEYE_API_CALL(is_GetImageInfo, {_camera_handle.handle, imgMemID, &imgInfo, (INT)sizeof(imgInfo)});
-
-                        std::tm tt;
-                        tt.tm_year = imgInfo.TimestampSystem.wYear - 1900;
-                        tt.tm_mon = imgInfo.TimestampSystem.wMonth - 1;
-                        tt.tm_mday = imgInfo.TimestampSystem.wDay;
-                        tt.tm_hour = imgInfo.TimestampSystem.wHour;
-                        tt.tm_min = imgInfo.TimestampSystem.wMinute;
-                        tt.tm_sec = imgInfo.TimestampSystem.wSecond;
-                        tt.tm_isdst = 0; // TODO: have to initialize member; query if is DST
-
-                        auto c_tt = mktime(&tt);
-                        auto millis = std::chrono::milliseconds(imgInfo.TimestampSystem.wMilliseconds);
-                        auto timestamp = std::chrono::system_clock::from_time_t(c_tt) + millis;
-
-                        PLOG_INFO << fmt::format("capture handle {{camera {} ({} [#{}])}} image #{}({}) @{}.{:03}", // timestamp will be formated without milliseconds by default
-                                                 _camera_handle.camera.deviceId,
-                                                 _camera_handle.camera.modelName,
-                                                 _camera_handle.camera.serialNo,
-                                                 imgInfo.u64TimestampDevice,
-                                                 imgInfo.u64FrameNumber,
-                                                 timestamp,
-                                                 millis.count());
-
-                        // callback executor task
-                        auto caller = [=]()
-                        {
-                            try
-                            {
-                                auto imgView = typedImageViewT(
-                                    (uint8_t *)imgMemPtr,
-                                    {sln::PixelLength(std::get<0>(_camera_handle._resolution)),
-                                     sln::PixelLength(std::get<1>(_camera_handle._resolution))});
-
-                                if (_camera_handle._uEye_color_mode == IS_CM_RGB12_UNPACKED) // RGB 16bit is actually 12bit
-                                {
-                                    PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image #{}({}) correcting 12bit <--> 16bit value scaling", // timestamp will be formated without milliseconds by default
-                                                              _camera_handle.camera.deviceId,
-                                                              _camera_handle.camera.modelName,
-                                                              _camera_handle.camera.serialNo,
-                                                              imgInfo.u64TimestampDevice,
-                                                              imgInfo.u64FrameNumber);
-
-                                    sln::for_each_pixel(imgView,
-                                                        [](auto &px)
-                                                        {
-                                                            constexpr double scaler = 65536 / 4096; //(std::pow(2, 16) - 1) / (std::pow(2, 12) - 1);
-                                                            px *= scaler;
-                                                        });
-                                }
-
-                                // dispatch callback with a selene image view
-                                imageCallback(
-                                    // imgView.constant_view(),
-                                    imgView.view(),
-                                    timestamp,
-                                    imgInfo.u64TimestampDevice,
-                                    imgInfo.u64FrameNumber);
-                            }
-                            catch (const std::exception &e)
-                            {
-                                PLOG_ERROR << fmt::format("capture handle {{camera {} ({} [#{}])}} error while executing callback for image #{}({}): {}",
-                                                          _camera_handle.camera.deviceId,
-                                                          _camera_handle.camera.modelName,
-                                                          _camera_handle.camera.serialNo,
-                                                          imgInfo.u64TimestampDevice,
-                                                          imgInfo.u64FrameNumber,
-                                                          e.what());
-                            }
-                            // unlock buffer
-                            UEYE_API_CALL(is_UnlockSeqBuf, {_camera_handle.handle, IS_IGNORE_PARAMETER, imgMemPtr});
-                        };
-
-                        // dispatch callback to threadpool
-                        _pool.push_task(caller);
-                    }
-                    catch (...)
-                    {
-                        PLOG_ERROR << fmt::format("capture handle {{camera {} ({} [#{}])}} FAILED TO QUERY DRIVER FOR CURRENT BUFFER AND INFO",
-                                                  _camera_handle.camera.deviceId,
-                                                  _camera_handle.camera.modelName,
-                                                  _camera_handle.camera.serialNo);
-                    }
+                    _handle_frame_event();
                 }
             }
             PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image dispatcher shut down",
@@ -262,81 +480,907 @@ namespace uEyeWrapper
     }
 
     template <typename H, captureType C>
-    void uEyeCaptureHandle<H, C>::_stop_threads()
+    void uEyeCaptureHandle<H, C>::_handle_frame_event()
     {
-        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} sending termination signal to background threads",
+        const auto wakeup = std::chrono::steady_clock::now();
+        const auto wakeup_system = std::chrono::system_clock::now();
+        frameTrace trace;
+        trace.instant("frame event", trace.mark());
+        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image dispatcher GOT IMAGE/FRAME",
                                   _camera_handle.camera.deviceId,
                                   _camera_handle.camera.modelName,
                                   _camera_handle.camera.serialNo);
-
-        // send event signal IS_SET_EVENT_TERMINATE_CAPTURE_THREADS
-        UINT terminate_event = IS_SET_EVENT_TERMINATE_CAPTURE_THREADS;
-        while (is_Event(_camera_handle.handle, IS_EVENT_CMD_SET, &terminate_event, sizeof(terminate_event)) != IS_SUCCESS)
+        try
         {
-            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed signaling threads to terminate, retrying...",
-                                        _camera_handle.camera.deviceId,
-                                        _camera_handle.camera.modelName,
-                                        _camera_handle.camera.serialNo);
-            std::this_thread::sleep_for(CAMERA_CLOSE_RETRY_WAIT);
-        }
+            // get buffer for last captured image
+            INT _seqBuffNum;
+            char *_currMemPtr;
+            char *imgMemPtr;
+            // the sequence may not shrink between retrieving and locking the buffer
+            auto sequence_lock = _camera_handle._memory_manager.share();
+            auto trace_begin = trace.mark();
+            UEYE_API_CALL(is_GetActSeqBuf, {_camera_handle.handle, &_seqBuffNum, &_currMemPtr, &imgMemPtr});
+            trace.span("is_GetActSeqBuf", trace_begin);
+            _camera_handle._memory_manager.frameArrived();
 
-        // join image dispatcher observer
-        if (_image_dispatcher_executor.joinable())
-        {
-            _image_dispatcher_executor.join();
-        }
+            if (!_camera_handle._memory_manager.contains(imgMemPtr))
+            {
+                PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} frame event for a buffer no longer in the sequence, skipping",
+                                          _camera_handle.camera.deviceId,
+                                          _camera_handle.camera.modelName,
+                                          _camera_handle.camera.serialNo);
+                return;
+            }
+            INT imgMemID = _camera_handle._memory_manager.getID(imgMemPtr);
 
-        // join pool
-        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} waiting for running image callbacks to finish",
-                                  _camera_handle.camera.deviceId,
-                                  _camera_handle.camera.modelName,
-                                  _camera_handle.camera.serialNo);
-        _pool.wait_for_tasks();
+            PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image in buffer {}[@{}]",
+                                      _camera_handle.camera.deviceId,
+                                      _camera_handle.camera.modelName,
+                                      _camera_handle.camera.serialNo,
+                                      imgMemID,
+                                      fmt::ptr(imgMemPtr));
 
-        // reset event signal
-        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} resetting termination signal to background threads",
-                                  _camera_handle.camera.deviceId,
-                                  _camera_handle.camera.modelName,
-                                  _camera_handle.camera.serialNo);
+            // batch mode: never lock the last free buffer, batches in flight would starve the driver
+            if (_batch_callback && _camera_handle._metrics.lockedBuffers.load(std::memory_order_relaxed) >= std::max<int64_t>(_camera_handle._metrics.sequenceBuffers.load(std::memory_order_relaxed), 2) - 1)
+            {
+                _camera_handle._metrics.frame(wakeup);
+                _camera_handle._metrics.droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} batch buffers exhausted, dropping image in buffer {}",
+                                          _camera_handle.camera.deviceId,
+                                          _camera_handle.camera.modelName,
+                                          _camera_handle.camera.serialNo,
+                                          imgMemID);
 
-        while (is_Event(_camera_handle.handle, IS_EVENT_CMD_RESET, &terminate_event, sizeof(terminate_event)) != IS_SUCCESS)
-        {
-            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed resetting terminate signal, retrying...",
-                                        _camera_handle.camera.deviceId,
-                                        _camera_handle.camera.modelName,
-                                        _camera_handle.camera.serialNo);
-            std::this_thread::sleep_for(CAMERA_CLOSE_RETRY_WAIT);
-        }
-    }
+                // the dropped frame still continues the sequence
+                UEYEIMAGEINFO imgInfo;
+                UEYE_API_CALL(is_GetImageInfo, {_camera_handle.handle, imgMemID, &imgInfo, (INT)sizeof(imgInfo)});
+                sequence_lock.unlock();
+                _track_frame(imgInfo);
+                _report_gap({frameGap::POLICY_DROPPED, 1, imgInfo.u64FrameNumber, std::chrono::nanoseconds(0), std::chrono::system_clock::now()});
+                return;
+            }
 
-    template <typename H, captureType C>
-    void uEyeCaptureHandle<H, C>::_stop_capture()
-    {
-        // TODO: error handling
-        try
-        {
-            UEYE_API_CALL(is_ForceTrigger, {_camera_handle.handle}); // stop all running capturing operations
-        }
-        catch(const std::runtime_error& e)
-        {
-            std::cerr << e.what() << '\n';
-            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} ignoring is_ForceTrigger error on camera capture stop; error msg: {}",
-                                        _camera_handle.camera.deviceId,
-                                        _camera_handle.camera.modelName,
-                                        _camera_handle.camera.serialNo,
-                                        e.what());
-        }
-        
-        UEYE_API_CALL(is_SetExternalTrigger, {_camera_handle.handle, IS_SET_TRIGGER_OFF});
-        UEYE_API_CALL(is_SetExternalTrigger, {_camera_handle.handle, IS_GET_TRIGGER_STATUS}); // from @anqixu/ueye_cam: documentation seems to suggest that this is needed to disable external trigger mode (to go into free-run mode)
-        UEYE_API_CALL(is_StopLiveVideo, {_camera_handle.handle, IS_WAIT});
-    }
+            // lock buffer
+            trace_begin = trace.mark();
+            UEYE_API_CALL(is_LockSeqBuf, {_camera_handle.handle, IS_IGNORE_PARAMETER, imgMemPtr});
+            trace.span("is_LockSeqBuf", trace_begin);
+            _camera_handle._metrics.lockedBuffers.fetch_add(1, std::memory_order_relaxed);
+            sequence_lock.unlock();
 
-    template <typename H, captureType C>
-    uEyeCaptureHandle<H, C>::~uEyeCaptureHandle()
-    {
-        _stop_capture();
-        _stop_threads();
+            // query image info and build timestamp
+            UEYEIMAGEINFO imgInfo;
+            trace_begin = trace.mark();
+            UEYE_API_CALL(is_GetImageInfo, {_camera_handle.handle, imgMemID, &imgInfo, (INT)sizeof(imgInfo)});
+            trace.span("is_GetImageInfo", trace_begin);
+
+            // write captureSettings queued for live capture between this frame and the next
+            const auto [settings, settings_generation] = _camera_handle._settings_for_frame(imgInfo.u64FrameNumber, _live_active.load(std::memory_order_relaxed));
+            if (settings)
+            {
+                _write_settings(*settings);
+            }
+            if (std::exchange(_frame_settings_generation, settings_generation) != settings_generation)
+            {
+                // the frame period may have changed
+                _gap_detector.resetPeriod();
+            }
+            _track_frame(imgInfo);
+
+            std::tm tt;
+            tt.tm_year = imgInfo.TimestampSystem.wYear - 1900;
+            tt.tm_mon = imgInfo.TimestampSystem.wMonth - 1;
+            tt.tm_mday = imgInfo.TimestampSystem.wDay;
+            tt.tm_hour = imgInfo.TimestampSystem.wHour;
+            tt.tm_min = imgInfo.TimestampSystem.wMinute;
+            tt.tm_sec = imgInfo.TimestampSystem.wSecond;
+            tt.tm_isdst = 0; // TODO: have to initialize member; query if is DST
+
+            auto c_tt = mktime(&tt);
+            auto millis = std::chrono::milliseconds(imgInfo.TimestampSystem.wMilliseconds);
+            auto timestamp = std::chrono::system_clock::from_time_t(c_tt) + millis;
+
+            _camera_handle._metrics.deviceToWakeup.record(wakeup_system - timestamp);
+            _camera_handle._metrics.frame(wakeup);
+
+            PLOG_RATE_LIMITED(plog::info, _frame_log_limiter) << fmt::format("capture handle {{camera {} ({} [#{}])}} image #{}({}) @{}.{:03} ({} frames not logged)", // timestamp will be formated without milliseconds by default
+                                                                             _camera_handle.camera.deviceId,
+                                                                             _camera_handle.camera.modelName,
+                                                                             _camera_handle.camera.serialNo,
+                                                                             imgInfo.u64TimestampDevice,
+                                                                             imgInfo.u64FrameNumber,
+                                                                             timestamp,
+                                                                             millis.count(),
+                                                                             _frame_log_limiter.suppressed());
+
+            // spans before the frame number was known are flushed here; the worker continues the trace
+            const bool traced = trace.enabled();
+            const auto queued_at = trace.mark();
+            trace.commit(_camera_handle.camera.deviceId, imgInfo.u64FrameNumber);
+
+            frameLeaseT lease(_camera_handle.handle,
+                              imgMemPtr,
+                              _image_view(imgMemPtr),
+                              {timestamp, imgInfo.u64TimestampDevice, imgInfo.u64FrameNumber, imgMemID, settings_generation},
+                              _camera_handle._metrics);
+
+            // pull mode: the queue takes over the locked buffer
+            if (_pull)
+            {
+                _queue_frame(std::move(lease), wakeup);
+                return;
+            }
+
+            if (_batch_callback)
+            {
+                _batch_frame(std::move(lease), wakeup);
+                return;
+            }
+
+            // shared by the owner callback and all subscribers; the buffer is unlocked with the last reference
+            auto frame = std::make_shared<frameLeaseT>(std::move(lease));
+
+            // callback executor task
+            auto caller = [=]() mutable
+            {
+                auto &metrics = _camera_handle._metrics;
+                const auto task_start = std::chrono::steady_clock::now();
+                frameTrace trace(traced);
+                trace.span("queued", queued_at);
+                auto trace_begin = trace.mark();
+                metrics.queueDepth.fetch_sub(1, std::memory_order_relaxed);
+                metrics.wakeupToTaskStart.record(task_start - wakeup);
+
+                // stale frame: unlock without running callback and subscribers
+                const auto max_age = _max_frame_age.load(std::memory_order_relaxed);
+                if (max_age.count() && task_start - wakeup > max_age)
+                {
+                    metrics.expiredFrames.fetch_add(1, std::memory_order_relaxed);
+                    PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image #{}({}) expired after {}us, skipping callback",
+                                              _camera_handle.camera.deviceId,
+                                              _camera_handle.camera.modelName,
+                                              _camera_handle.camera.serialNo,
+                                              imgInfo.u64TimestampDevice,
+                                              imgInfo.u64FrameNumber,
+                                              std::chrono::duration_cast<std::chrono::microseconds>(task_start - wakeup).count());
+                    frame.reset();
+                    _report_gap({frameGap::POLICY_DROPPED, 1, imgInfo.u64FrameNumber, std::chrono::nanoseconds(0), std::chrono::system_clock::now()});
+                    return;
+                }
+
+                try
+                {
+                    auto &imgView = frame->image();
+
+                    if (_camera_handle._uEye_color_mode == IS_CM_RGB12_UNPACKED) // RGB 16bit is actually 12bit
+                    {
+                        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} image #{}({}) correcting 12bit <--> 16bit value scaling", // timestamp will be formated without milliseconds by default
+                                                  _camera_handle.camera.deviceId,
+                                                  _camera_handle.camera.modelName,
+                                                  _camera_handle.camera.serialNo,
+                                                  imgInfo.u64TimestampDevice,
+                                                  imgInfo.u64FrameNumber);
+
+                        rescale_12_to_16_bit(imgView);
+                    }
+
+                    // dispatch callback with a selene image view
+                    if (imageCallback)
+                    {
+                        imageCallback(
+                            // imgView.constant_view(),
+                            imgView.view(),
+                            timestamp,
+                            imgInfo.u64TimestampDevice,
+                            imgInfo.u64FrameNumber);
+                    }
+                }
+                catch (const std::exception &e)
+                {
+                    metrics.callbackErrors.fetch_add(1, std::memory_order_relaxed);
+                    PLOG_ERROR << fmt::format("capture handle {{camera {} ({} [#{}])}} error while executing callback for image #{}({}): {}",
+                                              _camera_handle.camera.deviceId,
+                                              _camera_handle.camera.modelName,
+                                              _camera_handle.camera.serialNo,
+                                              imgInfo.u64TimestampDevice,
+                                              imgInfo.u64FrameNumber,
+                                              e.what());
+                }
+                metrics.callbackDuration.record(std::chrono::steady_clock::now() - task_start);
+                trace.span("callback", trace_begin);
+
+                // fan out const views to the subscribers, running in parallel after the owner modified the image
+                for (const auto &subscriber : *_subscribers_snapshot())
+                {
+                    _submit([this, frame, callback = subscriber.second]()
+                            {
+                                try
+                                {
+                                    callback(frame->image().constant_view(), frame->metadata());
+                                }
+                                catch (const std::exception &e)
+                                {
+                                    _camera_handle._metrics.callbackErrors.fetch_add(1, std::memory_order_relaxed);
+                                    PLOG_ERROR << fmt::format("capture handle {{camera {} ({} [#{}])}} error while executing subscriber for image #{}({}): {}",
+                                                              _camera_handle.camera.deviceId,
+                                                              _camera_handle.camera.modelName,
+                                                              _camera_handle.camera.serialNo,
+                                                              frame->metadata().deviceTimestamp,
+                                                              frame->metadata().frameNumber,
+                                                              e.what());
+                                } });
+                }
+
+                // unlock buffer, unless subscribers still hold it
+                trace_begin = trace.mark();
+                frame.reset();
+                trace.span("is_UnlockSeqBuf", trace_begin);
+                trace.commit(_camera_handle.camera.deviceId, imgInfo.u64FrameNumber);
+            };
+
+            // dispatch callback to threadpool
+            _camera_handle._metrics.queueDepth.fetch_add(1, std::memory_order_relaxed);
+            _submit_frame(std::move(caller));
+        }
+        catch (...)
+        {
+            PLOG_ERROR << fmt::format("capture handle {{camera {} ({} [#{}])}} FAILED TO QUERY DRIVER FOR CURRENT BUFFER AND INFO",
+                                      _camera_handle.camera.deviceId,
+                                      _camera_handle.camera.modelName,
+                                      _camera_handle.camera.serialNo);
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_batch_frame(frameLeaseT &&lease, std::chrono::steady_clock::time_point wakeup)
+    {
+        std::vector<frameLeaseT> full;
+        std::chrono::steady_clock::time_point first;
+        {
+            std::lock_guard<std::mutex> lock(_batch_mutex);
+            if (_batch.empty())
+            {
+                // the flusher starts waiting for the deadline of the new batch
+                _batch_wakeup = wakeup;
+                _batch_pending.notify_one();
+            }
+            _batch.push_back(std::move(lease));
+            if (_batch.size() < _batch_policy.maxFrames)
+            {
+                return;
+            }
+
+            full = std::exchange(_batch, {});
+            first = _batch_wakeup;
+            _batch_generation++;
+        }
+        _submit_batch(std::move(full), first);
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_SPAWN_batch_flusher()
+    {
+        // delivers batches incomplete at their deadline
+        auto flusher = [&]()
+        {
+            std::unique_lock<std::mutex> lock(_batch_mutex);
+            while (!_batch_closed)
+            {
+                if (_batch.empty())
+                {
+                    _batch_pending.wait(lock);
+                    continue;
+                }
+
+                const uint64_t generation = _batch_generation;
+                if (_batch_pending.wait_until(lock, _batch_wakeup + _batch_policy.maxWait, [&]()
+                                              { return _batch_closed || _batch_generation != generation; }))
+                {
+                    continue;
+                }
+
+                auto partial = std::exchange(_batch, {});
+                const auto first = _batch_wakeup;
+                _batch_generation++;
+                lock.unlock();
+                _submit_batch(std::move(partial), first);
+                lock.lock();
+            }
+        };
+
+        _batch_flusher = std::thread(flusher);
+        set_thread_name(_batch_flusher.native_handle(), _camera_handle._thread_name("bat"));
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_submit_batch(std::vector<frameLeaseT> &&frames, std::chrono::steady_clock::time_point wakeup)
+    {
+        // std::function requires copyable tasks
+        auto batch = std::make_shared<std::vector<frameLeaseT>>(std::move(frames));
+        const int64_t size = (int64_t)batch->size();
+
+        auto caller = [this, batch, size, wakeup]()
+        {
+            auto &metrics = _camera_handle._metrics;
+            const auto task_start = std::chrono::steady_clock::now();
+            metrics.queueDepth.fetch_sub(size, std::memory_order_relaxed);
+            metrics.wakeupToTaskStart.record(task_start - wakeup);
+
+            try
+            {
+                if (_camera_handle._uEye_color_mode == IS_CM_RGB12_UNPACKED) // RGB 16bit is actually 12bit
+                {
+                    for (auto &frame : *batch)
+                    {
+                        rescale_12_to_16_bit(frame.image());
+                    }
+                }
+                _batch_callback(*batch);
+            }
+            catch (const std::exception &e)
+            {
+                metrics.callbackErrors.fetch_add(1, std::memory_order_relaxed);
+                PLOG_ERROR << fmt::format("capture handle {{camera {} ({} [#{}])}} error while executing batch callback for images #{}..#{}: {}",
+                                          _camera_handle.camera.deviceId,
+                                          _camera_handle.camera.modelName,
+                                          _camera_handle.camera.serialNo,
+                                          batch->front().metadata().frameNumber,
+                                          batch->back().metadata().frameNumber,
+                                          e.what());
+            }
+            metrics.callbackDuration.record(std::chrono::steady_clock::now() - task_start);
+
+            // unlock buffers
+            batch->clear();
+        };
+
+        _camera_handle._metrics.queueDepth.fetch_add(size, std::memory_order_relaxed);
+        _submit(std::move(caller));
+    }
+
+    template <typename H, captureType C>
+    typename uEyeCaptureHandle<H, C>::typedImageViewT uEyeCaptureHandle<H, C>::_image_view(char *memory) const
+    {
+        return typedImageViewT(
+            (uint8_t *)memory,
+            {sln::PixelLength(std::get<0>(_camera_handle._resolution)),
+             sln::PixelLength(std::get<1>(_camera_handle._resolution))});
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_queue_frame(frameLeaseT &&lease, std::chrono::steady_clock::time_point wakeup)
+    {
+        std::optional<frameLeaseT> dropped;
+        std::function<void(bool)> ready;
+        {
+            std::lock_guard<std::mutex> lock(_frames_mutex);
+            ready = std::exchange(_frame_ready, nullptr);
+            // keep one sequence buffer for the driver, as in batch mode; otherwise a full queue holds all of them locked
+            if ((int64_t)_frames.size() >= std::max<int64_t>(_camera_handle._metrics.sequenceBuffers.load(std::memory_order_relaxed), 2) - 1)
+            {
+                dropped = std::move(_frames.front().lease);
+                _frames.pop_front();
+                _camera_handle._metrics.queueDepth.fetch_sub(1, std::memory_order_relaxed);
+                _camera_handle._metrics.droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            }
+            _frames.push_back({std::move(lease), wakeup});
+            _camera_handle._metrics.queueDepth.fetch_add(1, std::memory_order_relaxed);
+        }
+        _frames_available.notify_one();
+
+        if (dropped)
+        {
+            PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} frame queue full, dropping image #{}({})",
+                                      _camera_handle.camera.deviceId,
+                                      _camera_handle.camera.modelName,
+                                      _camera_handle.camera.serialNo,
+                                      dropped->metadata().deviceTimestamp,
+                                      dropped->metadata().frameNumber);
+            _report_gap({frameGap::POLICY_DROPPED, 1, dropped->metadata().frameNumber, std::chrono::nanoseconds(0), std::chrono::system_clock::now()});
+            dropped.reset();
+        }
+
+        // last: a consumer resumed inline may release this capture handle
+        if (ready)
+        {
+            ready(true);
+        }
+    }
+
+    template <typename H, captureType C>
+    typename uEyeCaptureHandle<H, C>::frameLeaseT uEyeCaptureHandle<H, C>::_take_frame(std::unique_lock<std::mutex> &lock)
+    {
+        queuedFrame frame = std::move(_frames.front());
+        _frames.pop_front();
+        lock.unlock();
+
+        _camera_handle._metrics.queueDepth.fetch_sub(1, std::memory_order_relaxed);
+        _camera_handle._metrics.wakeupToTaskStart.record(std::chrono::steady_clock::now() - frame.wakeup);
+
+        if (_camera_handle._uEye_color_mode == IS_CM_RGB12_UNPACKED) // RGB 16bit is actually 12bit
+        {
+            rescale_12_to_16_bit(frame.lease.image());
+        }
+        return std::move(frame.lease);
+    }
+
+    template <typename H, captureType C>
+    std::optional<typename uEyeCaptureHandle<H, C>::frameLeaseT> uEyeCaptureHandle<H, C>::nextFrame(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(_frames_mutex);
+        if (!_frames_available.wait_for(lock, timeout, [this]()
+                                        { return !_frames.empty(); }))
+        {
+            return std::nullopt;
+        }
+        return _take_frame(lock);
+    }
+
+    template <typename H, captureType C>
+    std::optional<typename uEyeCaptureHandle<H, C>::frameLeaseT> uEyeCaptureHandle<H, C>::tryNextFrame()
+    {
+        std::unique_lock<std::mutex> lock(_frames_mutex);
+        if (_frames.empty())
+        {
+            return std::nullopt;
+        }
+        return _take_frame(lock);
+    }
+
+    template <typename H, captureType C>
+    size_t uEyeCaptureHandle<H, C>::subscribe(subscriberCallbackT subscriber)
+    {
+        if (_pull)
+        {
+            throw std::logic_error("capture handle in pull mode; subscribers require an image callback or subscribers at construction");
+        }
+
+        std::lock_guard<std::mutex> lock(_subscribers_mutex);
+        auto subscribers = _subscribers ? std::make_shared<subscriberListT>(*_subscribers) : std::make_shared<subscriberListT>();
+        subscribers->emplace_back(_next_subscriber, std::move(subscriber));
+        _subscribers = std::move(subscribers);
+        return _next_subscriber++;
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::unsubscribe(size_t id)
+    {
+        std::lock_guard<std::mutex> lock(_subscribers_mutex);
+        if (!_subscribers)
+        {
+            return;
+        }
+        auto subscribers = std::make_shared<subscriberListT>(*_subscribers);
+        subscribers->erase(std::remove_if(subscribers->begin(), subscribers->end(), [id](const auto &subscriber)
+                                          { return subscriber.first == id; }),
+                           subscribers->end());
+        _subscribers = std::move(subscribers);
+    }
+
+    template <typename H, captureType C>
+    std::shared_ptr<const typename uEyeCaptureHandle<H, C>::subscriberListT> uEyeCaptureHandle<H, C>::_subscribers_snapshot()
+    {
+        static const auto none = std::make_shared<const subscriberListT>();
+        std::lock_guard<std::mutex> lock(_subscribers_mutex);
+        return _subscribers ? _subscribers : none;
+    }
+
+    template <typename H, captureType C>
+    bool uEyeCaptureHandle<H, C>::notifyFrame(std::function<void(bool)> ready)
+    {
+        std::lock_guard<std::mutex> lock(_frames_mutex);
+        if (!_frames.empty() || _frames_closed)
+        {
+            return false;
+        }
+        _frame_ready = std::move(ready);
+        return true;
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_submit(std::function<void()> &&task)
+    {
+        if (_scheduler_group)
+        {
+            _camera_handle._scheduler->submit(_scheduler_group, std::move(task));
+        }
+        else if (_pool)
+        {
+            _pool->push_task(std::move(task));
+        }
+        else
+        {
+            // shared reactor pool
+            _callbacks_in_flight.fetch_add(1, std::memory_order_relaxed);
+            _executor->push_task([this, task = std::move(task)]()
+                                 {
+                                     task();
+                                     _callbacks_in_flight.fetch_sub(1, std::memory_order_release); });
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_submit_frame(std::function<void()> &&task)
+    {
+        if (!_newest_first.load(std::memory_order_relaxed))
+        {
+            _submit(std::move(task));
+            return;
+        }
+
+        // one executor task per frame task; whichever runs first takes the newest frame
+        {
+            std::lock_guard<std::mutex> lock(_frame_tasks_mutex);
+            _frame_tasks.push_back(std::move(task));
+        }
+        _submit([this]()
+                {
+                    std::function<void()> newest;
+                    {
+                        std::lock_guard<std::mutex> lock(_frame_tasks_mutex);
+                        newest = std::move(_frame_tasks.back());
+                        _frame_tasks.pop_back();
+                    }
+                    newest(); });
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::setMaxFrameAge(std::chrono::microseconds maxAge)
+    {
+        _max_frame_age.store(maxAge, std::memory_order_relaxed);
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::setNewestFirst(bool newestFirst)
+    {
+        _newest_first.store(newestFirst, std::memory_order_relaxed);
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::onFrameGap(std::function<void(const frameGap &)> callback)
+    {
+        std::lock_guard<std::mutex> lock(_gap_callback_mutex);
+        _gap_callback = std::move(callback);
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_track_frame(const UEYEIMAGEINFO &imgInfo)
+    {
+        if (_gap_detector_restart.exchange(false, std::memory_order_relaxed))
+        {
+            _gap_detector.restart(_mode.load(std::memory_order_relaxed) == captureType::LIVE);
+        }
+        if (auto gap = _gap_detector.frame(imgInfo.u64FrameNumber, imgInfo.u64TimestampDevice, _camera_handle._error_stats.DEV_MISSED_IMAGES.count()))
+        {
+            _report_gap(*gap);
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_report_gap(const frameGap &gap)
+    {
+        static const char *causes[] = {"missed by the device", "skipped by the driver", "dropped by policy"};
+
+        // policy drops are counted where they happen (droppedFrames, expiredFrames)
+        switch (gap.reason)
+        {
+        case frameGap::DEVICE_MISSED:
+            _camera_handle._metrics.deviceMissedFrames.fetch_add(gap.frames, std::memory_order_relaxed);
+            break;
+        case frameGap::DRIVER_SKIPPED:
+            _camera_handle._metrics.driverSkippedFrames.fetch_add(gap.frames, std::memory_order_relaxed);
+            break;
+        default:
+            break;
+        }
+
+        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} {} frame(s) {} before image #{} (device interval {}us)",
+                                  _camera_handle.camera.deviceId,
+                                  _camera_handle.camera.modelName,
+                                  _camera_handle.camera.serialNo,
+                                  gap.frames,
+                                  causes[gap.reason],
+                                  gap.frameNumber,
+                                  std::chrono::duration_cast<std::chrono::microseconds>(gap.deviceInterval).count());
+
+        std::function<void(const frameGap &)> callback;
+        {
+            std::lock_guard<std::mutex> lock(_gap_callback_mutex);
+            callback = _gap_callback;
+        }
+        if (!callback)
+        {
+            return;
+        }
+
+        try
+        {
+            callback(gap);
+        }
+        catch (const std::exception &e)
+        {
+            _camera_handle._metrics.callbackErrors.fetch_add(1, std::memory_order_relaxed);
+            PLOG_ERROR << fmt::format("capture handle {{camera {} ({} [#{}])}} error while executing frame gap callback: {}",
+                                      _camera_handle.camera.deviceId,
+                                      _camera_handle.camera.modelName,
+                                      _camera_handle.camera.serialNo,
+                                      e.what());
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_wait_for_callbacks()
+    {
+        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} waiting for running image callbacks to finish",
+                                  _camera_handle.camera.deviceId,
+                                  _camera_handle.camera.modelName,
+                                  _camera_handle.camera.serialNo);
+
+        if (_scheduler_group)
+        {
+            _camera_handle._scheduler->wait(*_scheduler_group);
+        }
+        else if (_pool)
+        {
+            _pool->wait_for_tasks();
+        }
+        else
+        {
+            while (_callbacks_in_flight.load(std::memory_order_acquire))
+            {
+                std::this_thread::sleep_for(CAPTURE_CALLBACK_DRAIN_WAIT);
+            }
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_apply_thread_placement()
+    {
+        const auto &placement = _camera_handle._thread_placement;
+
+        // dispatcher: name, cpuset and real-time priority
+        auto dispatcher = _image_dispatcher_executor.native_handle();
+        set_thread_name(dispatcher, _camera_handle._thread_name("dsp"));
+        if (!set_thread_affinity(dispatcher, placement.dispatcherCPUs))
+        {
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed pinning image dispatcher to cpus {}",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo,
+                                        placement.dispatcherCPUs);
+        }
+        if (!set_thread_fifo_priority(dispatcher, placement.dispatcherPriority))
+        {
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed setting SCHED_FIFO priority {} for image dispatcher; missing CAP_SYS_NICE/RLIMIT_RTPRIO?",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo,
+                                        placement.dispatcherPriority);
+        }
+
+        // workers of a shared scheduler are not placed per camera
+        if (!_pool)
+        {
+            return;
+        }
+
+        // workers: the pool does not expose its threads; occupy every worker with one placement task at once
+        // the rendezvous guarantees each worker picks exactly one task and thereby configures itself
+        const size_t workers = _pool->get_thread_count();
+        std::mutex rendezvous_mutex;
+        std::condition_variable rendezvous;
+        size_t arrived = 0;
+        std::atomic<size_t> failed = 0;
+
+        for (size_t worker = 0; worker < workers; worker++)
+        {
+            _pool->push_task([&, worker]()
+                            {
+                                auto self = current_thread_native_handle();
+                                set_thread_name(self, _camera_handle._thread_name(fmt::format("wrk{}", worker)));
+                                if (!set_thread_affinity(self, placement.workerCPUs))
+                                {
+                                    failed++;
+                                }
+
+                                std::unique_lock<std::mutex> lock(rendezvous_mutex);
+                                arrived++;
+                                rendezvous.notify_all();
+                                rendezvous.wait(lock, [&]()
+                                                { return arrived == workers; }); });
+        }
+        _pool->wait_for_tasks();
+
+        if (failed)
+        {
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed pinning {}/{} pool workers to cpus {}",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo,
+                                        failed.load(),
+                                        workers,
+                                        placement.workerCPUs);
+        }
+    }
+
+    template <typename H, captureType C>
+    latencySummary uEyeCaptureHandle<H, C>::dispatchLatency() const
+    {
+        return _camera_handle._metrics.wakeupToTaskStart.summary();
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_stop_threads()
+    {
+        if (_camera_handle._reactor)
+        {
+            // no frame handler runs after removal, unless removed from within it; afterwards only queued callbacks remain
+            _camera_handle._reactor->remove(_reactor_registration);
+            _wait_for_callbacks();
+            return;
+        }
+
+        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} sending termination signal to background threads",
+                                  _camera_handle.camera.deviceId,
+                                  _camera_handle.camera.modelName,
+                                  _camera_handle.camera.serialNo);
+
+        // send event signal IS_SET_EVENT_TERMINATE_CAPTURE_THREADS
+        UINT terminate_event = IS_SET_EVENT_TERMINATE_CAPTURE_THREADS;
+        while (is_Event(_camera_handle.handle, IS_EVENT_CMD_SET, &terminate_event, sizeof(terminate_event)) != IS_SUCCESS)
+        {
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed signaling threads to terminate, retrying...",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo);
+            std::this_thread::sleep_for(CAMERA_CLOSE_RETRY_WAIT);
+        }
+
+        // join image dispatcher observer
+        if (_image_dispatcher_executor.joinable())
+        {
+            _image_dispatcher_executor.join();
+        }
+
+        // join pool
+        _wait_for_callbacks();
+
+        // reset event signal
+        PLOG_DEBUG << fmt::format("capture handle {{camera {} ({} [#{}])}} resetting termination signal to background threads",
+                                  _camera_handle.camera.deviceId,
+                                  _camera_handle.camera.modelName,
+                                  _camera_handle.camera.serialNo);
+
+        while (is_Event(_camera_handle.handle, IS_EVENT_CMD_RESET, &terminate_event, sizeof(terminate_event)) != IS_SUCCESS)
+        {
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed resetting terminate signal, retrying...",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo);
+            std::this_thread::sleep_for(CAMERA_CLOSE_RETRY_WAIT);
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_stop_capture()
+    {
+        // TODO: error handling
+        try
+        {
+            UEYE_API_CALL(is_ForceTrigger, {_camera_handle.handle}); // stop all running capturing operations
+        }
+        catch(const std::runtime_error& e)
+        {
+            std::cerr << e.what() << '\n';
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} ignoring is_ForceTrigger error on camera capture stop; error msg: {}",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo,
+                                        e.what());
+        }
+        
+        UEYE_API_CALL(is_SetExternalTrigger, {_camera_handle.handle, IS_SET_TRIGGER_OFF});
+        UEYE_API_CALL(is_SetExternalTrigger, {_camera_handle.handle, IS_GET_TRIGGER_STATUS}); // from @anqixu/ueye_cam: documentation seems to suggest that this is needed to disable external trigger mode (to go into free-run mode)
+        UEYE_API_CALL(is_StopLiveVideo, {_camera_handle.handle, IS_WAIT});
+
+        // settings queued for a dispatcher that will not see another frame
+        if (_live_active.exchange(false, std::memory_order_relaxed))
+        {
+            auto settings_lock = _camera_handle._settings_write_lock();
+            if (auto pending = _camera_handle._live_capture(false))
+            {
+                _write_settings(*pending);
+            }
+        }
+
+        if (_capturing.exchange(false))
+        {
+            _camera_handle._memory_manager.capturing(false);
+        }
+    }
+
+    template <typename H, captureType C>
+    void uEyeCaptureHandle<H, C>::_write_settings(const captureSettings &settings)
+    {
+        // runs on the dispatcher between frames; a failure must not lose the frame
+        try
+        {
+            double newFPS = 0;
+            if (settings.FPS)
+            {
+                UEYE_API_CALL(is_SetFrameRate, {_camera_handle.handle, *settings.FPS, &newFPS});
+            }
+            double exposure = settings.exposure.value_or(0);
+            if (settings.exposure)
+            {
+                UEYE_API_CALL(is_Exposure, {_camera_handle.handle, IS_EXPOSURE_CMD_SET_EXPOSURE, (void *)&exposure, (UINT)sizeof(exposure)});
+            }
+
+            PLOG_INFO << fmt::format("capture handle {{camera {} ({} [#{}])}} capture settings written (FPS {}, exposure {}ms)",
+                                     _camera_handle.camera.deviceId,
+                                     _camera_handle.camera.modelName,
+                                     _camera_handle.camera.serialNo,
+                                     settings.FPS ? fmt::format("{}", newFPS) : "kept",
+                                     settings.exposure ? fmt::format("{}", exposure) : "kept");
+        }
+        catch (const std::exception &e)
+        {
+            PLOG_WARNING << fmt::format("capture handle {{camera {} ({} [#{}])}} failed writing capture settings: {}",
+                                        _camera_handle.camera.deviceId,
+                                        _camera_handle.camera.modelName,
+                                        _camera_handle.camera.serialNo,
+                                        e.what());
+        }
+    }
+
+    template <typename H, captureType C>
+    uEyeCaptureHandle<H, C>::~uEyeCaptureHandle()
+    {
+        // wake a waiting consumer, it must not touch the handle anymore
+        std::function<void(bool)> ready;
+        {
+            std::lock_guard<std::mutex> lock(_frames_mutex);
+            _frames_closed = true;
+            ready = std::exchange(_frame_ready, nullptr);
+        }
+        if (ready)
+        {
+            ready(false);
+        }
+
+        _cancel_triggers();
+        if (!_paused.load(std::memory_order_relaxed))
+        {
+            _stop_capture();
+        }
+
+        // no deadline flush after this point; a batch submitted by the flusher is waited for below
+        const bool batched = _batch_flusher.joinable();
+        if (batched)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_batch_mutex);
+                _batch_closed = true;
+            }
+            _batch_pending.notify_one();
+            _batch_flusher.join();
+        }
+
+        _stop_threads();
+
+        // deliver the last incomplete batch
+        if (batched)
+        {
+            if (!_batch.empty())
+            {
+                _submit_batch(std::exchange(_batch, {}), _batch_wakeup);
+            }
+            _wait_for_callbacks();
+        }
+
+        // unlock frames not taken in pull mode
+        std::lock_guard<std::mutex> lock(_frames_mutex);
+        _camera_handle._metrics.queueDepth.fetch_sub((int64_t)_frames.size(), std::memory_order_relaxed);
+        _frames.clear();
     }
 
     // explicitly instantiate templates
@@ -348,9 +1392,37 @@ namespace uEyeWrapper
     template class uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>;
     template class uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>;
     template class uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>;
+    template class uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>;
+    template class uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>;
+    template class uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>;
+    template class uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>;
 
     template void uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER>::trigger<void>(bool);
     template void uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>::trigger<void>(bool);
     template void uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>::trigger<void>(bool);
     template void uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>::trigger<void>(bool);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>::trigger<void>(bool);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>::trigger<void>(bool);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>::trigger<void>(bool);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>::trigger<void>(bool);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>::triggerAt<size_t>(std::chrono::system_clock::time_point, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template size_t uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>::triggerEvery<size_t>(std::chrono::system_clock::time_point, std::chrono::nanoseconds, triggerTimer &);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>::setCaptureType<void>(captureType);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>::setCaptureType<void>(captureType);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>::setCaptureType<void>(captureType);
+    template void uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>::setCaptureType<void>(captureType);
 }
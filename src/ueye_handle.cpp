@@ -1,10 +1,12 @@
 #include "ueye_handle.h"
 #include "ueye_wrapper.h"
+#include "config_cache.h"
+#include "pixel_clock_planner.h"
 
 #include <type_traits>
 #include <math.h>
-#include <deque>
 #include <algorithm>
+#include <memory>
 using namespace std::chrono_literals;
 
 #include <stdio.h>
@@ -90,6 +92,49 @@ namespace uEyeWrapper
         }
     }
 
+    void uploadProgressHandlerFleetBar(const fleetUploadProgress &progress)
+    {
+        static std::unique_ptr<indicators::ProgressBar> bar;
+        static std::tuple<size_t, size_t, size_t> reported = {0, 0, 0};
+
+        if (STDOUTTTY)
+        {
+            if (progress.uploading == 0)
+            {
+                if (bar)
+                {
+                    bar->set_progress(100);
+                    bar.reset();
+                }
+                return;
+            }
+
+            const std::string prefix = fmt::format("Uploading FW: {} cameras ({} complete, {} failed) ", progress.uploading, progress.completed, progress.failed);
+            const size_t reserved = prefix.length() + std::char_traits<char>::length("[] XXX% ");
+            if (!bar)
+            {
+                bar = std::make_unique<indicators::ProgressBar>(
+                    indicators::option::BarWidth(indicators::terminal_width() - reserved),
+                    indicators::option::PrefixText{prefix},
+                    indicators::option::ShowPercentage{true});
+            }
+            bar->set_option(indicators::option::PrefixText{prefix});
+            bar->set_option(indicators::option::BarWidth(indicators::terminal_width() - reserved));
+            bar->set_progress((size_t)progress.percent);
+        }
+        else if (std::make_tuple(progress.uploading, progress.completed, progress.failed) != reported)
+        {
+            // log on uploads starting or finishing only
+            reported = {progress.uploading, progress.completed, progress.failed};
+            PLOG_WARNING << fmt::format(
+                "starter firmware upload: {} in progress, {} complete, {} failed; remaining time ~{}",
+                progress.uploading,
+                progress.completed,
+                progress.failed,
+                progress.remaining);
+        }
+    }
+
     /////////////////////////////////////////////////
     // uEyeHandle impl
 
@@ -98,22 +143,27 @@ namespace uEyeWrapper
     template <imageColorMode M, imageBitDepth D>
     UEYE_API_CALL_MEMBER_DEF(uEyeHandle<M,D>)
     {
-        auto _msg = msg;
-        const std::string common_prefix = fmt::format(
-            "[{}@{}] camera {} ({} [#{}])",
-            caller_name,
-            caller_line,
-            camera.deviceId,
-            camera.modelName,
-            camera.serialNo);
+        // the prefix is only formatted on failure or with debug logging enabled
+        auto common_prefix = [&]()
+        {
+            return fmt::format(
+                "[{}@{}] camera {} ({} [#{}])",
+                caller_name,
+                caller_line,
+                camera.deviceId,
+                camera.modelName,
+                camera.serialNo);
+        };
 
         int nret = std::apply(f, f_args);
         if (nret != IS_SUCCESS)
         {
+            std::string _msg(msg);
+
             // query API for error message if user supplied message is empty and return code is IS_NO_SUCCESS
             if (_msg.length() == 0 && nret == IS_NO_SUCCESS)
             {
-                PLOG_DEBUG << fmt::format("{}: querying API for error message", common_prefix);
+                PLOG_DEBUG << fmt::format("{}: querying API for error message", common_prefix());
                 auto err_info = _get_last_error_msg();
                 _msg = std::get<1>(err_info);
             }
@@ -126,13 +176,13 @@ namespace uEyeWrapper
                 nret);
 
             // log the error as warning from wrapper; error handling shall be done by user
-            PLOG_WARNING << fmt::format("{}: {}", common_prefix, common_msg);
+            PLOG_WARNING << fmt::format("{}: {}", common_prefix(), common_msg);
 
             // if a cleanup is required and a handler function is provided, execute it
-            if (cleanup_handler)
+            if constexpr (!std::is_null_pointer_v<std::decay_t<CleanupT>>)
             {
-                PLOG_WARNING << fmt::format("{}: calling provided cleanup handler after failed call to {}()", common_prefix, f_name);
-                cleanup_handler();
+                PLOG_WARNING << fmt::format("{}: calling provided cleanup handler after failed call to {}()", common_prefix(), f_name);
+                _api_cleanup(std::forward<CleanupT>(cleanup_handler));
             }
 
             // throw error
@@ -140,7 +190,7 @@ namespace uEyeWrapper
         }
 
         // log API method name and return code for debugging purposes (nret will allways be IS_SUCCESS(0) here)
-        PLOG_DEBUG << fmt::format("{}: {}() returned with code {}", common_prefix, f_name, nret);
+        PLOG_DEBUG << fmt::format("{}: {}() returned with code {}", common_prefix(), f_name, nret);
     }
 
     template <imageColorMode M, imageBitDepth D>
@@ -152,8 +202,11 @@ namespace uEyeWrapper
                                                                                                                   resolution(_resolution),
                                                                                                                   sensor(_sensor),
                                                                                                                   errorStats(_error_stats),
+                                                                                                                  placement(_thread_placement),
+                                                                                                                  metrics(_metrics),
                                                                                                                   captureErrorCallback(captureErrorCallback),
                                                                                                                   handle(0),
+                                                                                                                  _pixel_clock_objective(pixelClockObjective::minimalBandwidth),
                                                                                                                   _channels((std::underlying_type_t<decltype(M)>)M),
                                                                                                                   _bit_depth((std::underlying_type_t<decltype(D)>)D),
                                                                                                                   _uEye_color_mode(M == imageColorMode::MONO ?                                                                     // switch on color channels
@@ -167,7 +220,12 @@ namespace uEyeWrapper
                                                                                                                                 {IS_SET_EVENT_CAPTURE_STATUS, FALSE, TRUE},
                                                                                                                                 // terminate thread event will not reset and will be available continuously after signaling
                                                                                                                                 {IS_SET_EVENT_TERMINATE_HANDLE_THREADS, TRUE, FALSE},
-                                                                                                                                {IS_SET_EVENT_TERMINATE_CAPTURE_THREADS, TRUE, FALSE}})
+                                                                                                                                {IS_SET_EVENT_TERMINATE_CAPTURE_THREADS, TRUE, FALSE}}),
+                                                                                                                  _settings_generation(0),
+                                                                                                                  _settings_effective_frame(0),
+                                                                                                                  _live_captures(0),
+                                                                                                                  _reactor(nullptr),
+                                                                                                                  _scheduler(nullptr)
     {
         // setup data
         std::transform(_events_init.begin(), _events_init.end(),
@@ -223,9 +281,16 @@ namespace uEyeWrapper
 
     template <imageColorMode M, imageBitDepth D>
     template <captureType C>
-    uEyeCaptureHandle<uEyeHandle<M, D>, C> uEyeHandle<M, D>::getCaptureHandle(typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::imageCallbackT imageCallback)
+    uEyeCaptureHandle<uEyeHandle<M, D>, C> uEyeHandle<M, D>::getCaptureHandle(typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::imageCallbackT imageCallback, std::vector<typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::subscriberCallbackT> subscribers)
+    {
+        return uEyeCaptureHandle<uEyeHandle<M, D>, C>(*this, imageCallback, std::move(subscribers));
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    template <captureType C>
+    uEyeCaptureHandle<uEyeHandle<M, D>, C> uEyeHandle<M, D>::getBatchCaptureHandle(typename uEyeCaptureHandle<uEyeHandle<M, D>, C>::batchCallbackT batchCallback, batchPolicy policy)
     {
-        return uEyeCaptureHandle<uEyeHandle<M, D>, C>(*this, imageCallback);
+        return uEyeCaptureHandle<uEyeHandle<M, D>, C>(*this, std::move(batchCallback), policy);
     }
 
     template <imageColorMode M, imageBitDepth D>
@@ -451,12 +516,40 @@ namespace uEyeWrapper
             camera.modelName,
             camera.serialNo);
 
-        UEYE_API_CALL(is_AutoParameter, {handle, IS_AES_CMD_GET_CONFIGURATION_DEFAULT, pAesConfiguration, nSizeOfParam}, [&]()
-                      { delete pBuffer; });
-        UEYE_API_CALL(is_AutoParameter, {handle, IS_AES_CMD_SET_ENABLE, &nEnable, (UINT)sizeof(nEnable)}, [&]()
-                      { delete pBuffer; });
-        UEYE_API_CALL(is_AutoParameter, {handle, IS_AES_CMD_SET_CONFIGURATION, pAesConfiguration, nSizeOfParam}, [&]()
-                      { delete pBuffer; });
+        // apply cached defaults; the camera accepting them is the validation
+        bool applied = false;
+        const auto cached = cameraConfigCache::global().get(camera);
+        if (cached.aesDefault.size() == nSizeOfParam)
+        {
+            std::memcpy(pBuffer, cached.aesDefault.data(), nSizeOfParam);
+            UEYE_API_CALL(is_AutoParameter, {handle, IS_AES_CMD_SET_ENABLE, &nEnable, (UINT)sizeof(nEnable)}, [&]()
+                          { delete pBuffer; });
+            applied = is_AutoParameter(handle, IS_AES_CMD_SET_CONFIGURATION, pAesConfiguration, nSizeOfParam) == IS_SUCCESS;
+            if (!applied)
+            {
+                PLOG_WARNING << fmt::format(
+                    "camera {} ({} [#{}]) rejected cached auto control parameters; querying defaults",
+                    camera.deviceId,
+                    camera.modelName,
+                    camera.serialNo);
+
+                std::memset(pBuffer, 0, nSizeOfParam);
+                pAesConfiguration->nMode = IS_AES_MODE_PEAK;
+            }
+        }
+
+        if (!applied)
+        {
+            UEYE_API_CALL(is_AutoParameter, {handle, IS_AES_CMD_GET_CONFIGURATION_DEFAULT, pAesConfiguration, nSizeOfParam}, [&]()
+                          { delete pBuffer; });
+            UEYE_API_CALL(is_AutoParameter, {handle, IS_AES_CMD_SET_ENABLE, &nEnable, (UINT)sizeof(nEnable)}, [&]()
+                          { delete pBuffer; });
+            UEYE_API_CALL(is_AutoParameter, {handle, IS_AES_CMD_SET_CONFIGURATION, pAesConfiguration, nSizeOfParam}, [&]()
+                          { delete pBuffer; });
+
+            cameraConfigCache::global().update(camera, [&](cameraConfigCacheEntry &entry)
+                                               { entry.aesDefault.assign(pBuffer, pBuffer + nSizeOfParam); });
+        }
 
         // TODO: print values acquired from camera
         PLOG_INFO << fmt::format(
@@ -497,10 +590,23 @@ namespace uEyeWrapper
             camera.modelName,
             camera.serialNo);
 
-        // set default color model
+        // set default color model; cached or queried
         UINT colorModel;
-        UEYE_API_CALL(is_ColorTemperature, {handle, COLOR_TEMPERATURE_CMD_GET_RGB_COLOR_MODEL_DEFAULT, &colorModel, (UINT)sizeof(colorModel)});
-        UEYE_API_CALL(is_ColorTemperature, {handle, COLOR_TEMPERATURE_CMD_SET_RGB_COLOR_MODEL, &colorModel, (UINT)sizeof(colorModel)});
+        bool applied = false;
+        const auto cached = cameraConfigCache::global().get(camera).wbColorModelDefault;
+        if (cached)
+        {
+            colorModel = *cached;
+            applied = is_ColorTemperature(handle, COLOR_TEMPERATURE_CMD_SET_RGB_COLOR_MODEL, &colorModel, sizeof(colorModel)) == IS_SUCCESS;
+        }
+        if (!applied)
+        {
+            UEYE_API_CALL(is_ColorTemperature, {handle, COLOR_TEMPERATURE_CMD_GET_RGB_COLOR_MODEL_DEFAULT, &colorModel, (UINT)sizeof(colorModel)});
+            UEYE_API_CALL(is_ColorTemperature, {handle, COLOR_TEMPERATURE_CMD_SET_RGB_COLOR_MODEL, &colorModel, (UINT)sizeof(colorModel)});
+
+            cameraConfigCache::global().update(camera, [&](cameraConfigCacheEntry &entry)
+                                               { entry.wbColorModelDefault = colorModel; });
+        }
 
         PLOG_INFO << fmt::format(
             "camera {} ({} [#{}]) set default white balance color model ({})",
@@ -536,12 +642,18 @@ namespace uEyeWrapper
                 camera.serialNo);
         }
 
-        // query color temperature range
+        // query color temperature range; cached or queried
         UINT tempMin;
         UINT tempMax;
+        const auto cachedRange = cameraConfigCache::global().get(camera).wbTemperatureRange;
+        if (cachedRange)
+        {
+            std::tie(tempMin, tempMax) = *cachedRange;
+        }
         if (
-            is_ColorTemperature(handle, COLOR_TEMPERATURE_CMD_GET_TEMPERATURE_MIN, &tempMin, sizeof(tempMin)) != IS_SUCCESS ||
-            is_ColorTemperature(handle, COLOR_TEMPERATURE_CMD_GET_TEMPERATURE_MAX, &tempMax, sizeof(tempMax)) != IS_SUCCESS)
+            !cachedRange &&
+            (is_ColorTemperature(handle, COLOR_TEMPERATURE_CMD_GET_TEMPERATURE_MIN, &tempMin, sizeof(tempMin)) != IS_SUCCESS ||
+             is_ColorTemperature(handle, COLOR_TEMPERATURE_CMD_GET_TEMPERATURE_MAX, &tempMax, sizeof(tempMax)) != IS_SUCCESS))
         {
             // failed
             PLOG_WARNING << fmt::format(
@@ -564,6 +676,12 @@ namespace uEyeWrapper
 
             // adjust temperature to range
             kelvin = std::max(tempMin, std::min(tempMax, kelvin));
+
+            if (!cachedRange)
+            {
+                cameraConfigCache::global().update(camera, [&](cameraConfigCacheEntry &entry)
+                                                   { entry.wbTemperatureRange = std::make_tuple(tempMin, tempMax); });
+            }
         }
 
         PLOG_INFO << fmt::format(
@@ -574,7 +692,14 @@ namespace uEyeWrapper
             kelvin);
 
         INT kelvin_typed = kelvin;
-        UEYE_API_CALL(is_ColorTemperature, {handle, COLOR_TEMPERATURE_CMD_SET_TEMPERATURE, &kelvin_typed, (UINT)sizeof(kelvin_typed)});
+        UEYE_API_CALL(is_ColorTemperature, {handle, COLOR_TEMPERATURE_CMD_SET_TEMPERATURE, &kelvin_typed, (UINT)sizeof(kelvin_typed)}, [&]()
+                      {
+                          // rejected temperature may be due to a stale cached range; query again next time
+                          if (cachedRange)
+                          {
+                              cameraConfigCache::global().update(camera, [](cameraConfigCacheEntry &entry)
+                                                                 { entry.wbTemperatureRange.reset(); });
+                          } });
 
         PLOG_INFO << fmt::format(
             "camera {} ({} [#{}]) set white balance color temperature as {}K - OK",
@@ -666,6 +791,24 @@ namespace uEyeWrapper
 
     template <imageColorMode M, imageBitDepth D>
     double uEyeHandle<M, D>::setFPS(double FPS)
+    {
+        std::lock_guard<std::mutex> write_lock(_settings_write_mutex);
+        {
+            // probing pixel clocks while the sensor delivers frames corrupts them
+            std::lock_guard<std::mutex> lock(_settings_mutex);
+            if (_live_captures)
+            {
+                throw std::logic_error(fmt::format("camera {} ({} [#{}]) setFPS() requires live capture to be stopped; use setCaptureSettings() while capturing",
+                                                   camera.deviceId,
+                                                   camera.modelName,
+                                                   camera.serialNo));
+            }
+        }
+        return _set_FPS(FPS);
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    double uEyeHandle<M, D>::_set_FPS(double FPS)
     {
         PLOG_INFO << fmt::format(
             "camera {} ({} [#{}]) requested setting FPS to {}",
@@ -692,11 +835,44 @@ namespace uEyeWrapper
             minFPS,
             maxFPS);
 
-        // FPS out of current pixel clocks range
-        if (maxFPS < FPS)
+        // FPS out of current pixel clocks range; try the pixel clock found for this FPS before
+        const auto cachedClocks = cameraConfigCache::global().get(camera).pixelClock;
+        const auto cachedClock = cachedClocks.find(FPS);
+        if ((maxFPS < FPS || minFPS > FPS) && cachedClock != cachedClocks.end() && _pixel_clock_objective == pixelClockObjective::minimalBandwidth)
+        {
+            clk = cachedClock->second;
+            if (is_PixelClock(handle, IS_PIXELCLOCK_CMD_SET, (void *)&clk, sizeof(clk)) == IS_SUCCESS)
+            {
+                UEYE_API_CALL(is_GetFrameTimeRange, {handle, &frameTimingMin, &frameTimingMax, &frameTimingIntervall});
+                minFPS = 1 / frameTimingMax;
+                maxFPS = 1 / frameTimingMin;
+
+                PLOG_INFO << fmt::format(
+                    "camera {} ({} [#{}]) using cached pixel clock {}MHz; FPS range [{}-{}]{}",
+                    camera.deviceId,
+                    camera.modelName,
+                    camera.serialNo,
+                    clk,
+                    minFPS,
+                    maxFPS,
+                    maxFPS < FPS || minFPS > FPS ? "; insufficient, searching" : "");
+            }
+            else
+            {
+                PLOG_WARNING << fmt::format(
+                    "camera {} ({} [#{}]) rejected cached pixel clock {}MHz; searching",
+                    camera.deviceId,
+                    camera.modelName,
+                    camera.serialNo,
+                    clk);
+            }
+        }
+
+        // FPS out of current pixel clocks range, or minimal latency requested
+        if (maxFPS < FPS || minFPS > FPS || _pixel_clock_objective == pixelClockObjective::minimalLatency)
         {
             PLOG_INFO << fmt::format(
-                "camera {} ({} [#{}]) requested FPS out of current pixel clock range; adjusting pixel clock...",
+                "camera {} ({} [#{}]) requested FPS out of current pixel clock range or minimal latency requested; adjusting pixel clock...",
                 camera.deviceId,
                 camera.modelName,
                 camera.serialNo);
@@ -757,46 +933,50 @@ namespace uEyeWrapper
             }
 
             PLOG_INFO << fmt::format(
-                "camera {} ({} [#{}]) trying to find lowest pixel clock capable of supporting desired FPS from {}",
+                "camera {} ({} [#{}]) trying to find {} pixel clock capable of supporting desired FPS from {}",
                 camera.deviceId,
                 camera.modelName,
                 camera.serialNo,
+                _pixel_clock_objective == pixelClockObjective::minimalBandwidth ? "lowest" : "highest",
                 clkList);
 
-            // vector has available clocks set; pop elements from front til we reach the first element greater than our current clock
-            auto nextClk = std::find_if(clkList.begin(), clkList.end(), [clk](UINT clkElem)
-                                        { return clkElem > clk; });
-            std::deque<UINT> clkOpts(nextClk, clkList.end());
+            // probe: set clock and query FPS range
+            const auto plan = pixelClockPlanner(clkList, clk, {minFPS, maxFPS}).plan(FPS, _pixel_clock_objective, [&](UINT probeClk)
+                                                                         {
+                                                                             UEYE_API_CALL(is_PixelClock, {handle, IS_PIXELCLOCK_CMD_SET, (void *)&probeClk, (UINT)sizeof(UINT)});
+                                                                             UEYE_API_CALL(is_GetFrameTimeRange, {handle, &frameTimingMin, &frameTimingMax, &frameTimingIntervall});
+                                                                             minFPS = 1 / frameTimingMax;
+                                                                             maxFPS = 1 / frameTimingMin;
+
+                                                                             PLOG_DEBUG << fmt::format(
+                                                                                 "camera {} ({} [#{}]) FPS range for pixel clock(@{}MHz) [{}-{}]",
+                                                                                 camera.deviceId,
+                                                                                 camera.modelName,
+                                                                                 camera.serialNo,
+                                                                                 probeClk,
+                                                                                 minFPS,
+                                                                                 maxFPS);
+                                                                             return fpsRange{minFPS, maxFPS};
+                                                                         });
+            clk = plan.clock;
+            minFPS = plan.FPS.min;
+            maxFPS = plan.FPS.max;
 
-            // loop through pixel clocks till we can set desired FPS
-            while (FPS > maxFPS && !clkOpts.empty()) //desired FPS within range
-            {
-                // set clock
-                PLOG_INFO << fmt::format(
-                    "camera {} ({} [#{}]) setting pixel clock to {}MHz",
-                    camera.deviceId,
-                    camera.modelName,
-                    camera.serialNo,
-                    clkOpts.front());
-
-                UEYE_API_CALL(is_PixelClock, {handle, IS_PIXELCLOCK_CMD_SET, (void *)&(clkOpts.front()), (UINT)sizeof(UINT)});
-                // , fmt::format("failed setting pixel clock to {}MHz", clkOpts.front()));
-
-                // get FPS range
-                UEYE_API_CALL(is_GetFrameTimeRange, {handle, &frameTimingMin, &frameTimingMax, &frameTimingIntervall});
-                minFPS = 1 / frameTimingMax;
-                maxFPS = 1 / frameTimingMin;
-
-                PLOG_INFO << fmt::format(
-                    "camera {} ({} [#{}]) FPS range for current pixel clock(@{}MHz) [{}-{}]",
-                    camera.deviceId,
-                    camera.modelName,
-                    camera.serialNo,
-                    clkOpts.front(),
-                    minFPS,
-                    maxFPS);
+            PLOG_INFO << fmt::format(
+                "camera {} ({} [#{}]) set pixel clock to {}MHz after {} probes; FPS range [{}-{}]{}",
+                camera.deviceId,
+                camera.modelName,
+                camera.serialNo,
+                clk,
+                plan.probes,
+                minFPS,
+                maxFPS,
+                plan.feasible ? "" : "; requested FPS not supported");
 
-                clkOpts.pop_front();
+            if (plan.feasible && _pixel_clock_objective == pixelClockObjective::minimalBandwidth)
+            {
+                cameraConfigCache::global().update(camera, [&](cameraConfigCacheEntry &entry)
+                                                   { entry.pixelClock[FPS] = clk; });
             }
         }
 
@@ -815,6 +995,198 @@ namespace uEyeWrapper
         return newFPS;
     }
 
+    template <imageColorMode M, imageBitDepth D>
+    uint64_t uEyeHandle<M, D>::setCaptureSettings(captureSettings settings)
+    {
+        // capture starts wait, so the pixel clock does not change once live capture runs
+        std::lock_guard<std::mutex> write_lock(_settings_write_mutex);
+        {
+            std::lock_guard<std::mutex> lock(_settings_mutex);
+            if (_live_captures)
+            {
+                // the pixel clock can not change while capturing
+                if (settings.FPS)
+                {
+                    double frameTimingMin, frameTimingMax, frameTimingIntervall;
+                    UEYE_API_CALL(is_GetFrameTimeRange, {handle, &frameTimingMin, &frameTimingMax, &frameTimingIntervall});
+                    if (*settings.FPS > 1 / frameTimingMin || *settings.FPS < 1 / frameTimingMax)
+                    {
+                        throw std::logic_error(fmt::format("requested FPS {} outside the range [{}-{}] of the current pixel clock; stop live capture to change it", *settings.FPS, 1 / frameTimingMax, 1 / frameTimingMin));
+                    }
+                }
+
+                // merged with settings not yet written; they share the generation
+                if (!_pending_settings)
+                {
+                    _pending_settings = settings;
+                }
+                else
+                {
+                    _pending_settings->FPS = settings.FPS ? settings.FPS : _pending_settings->FPS;
+                    _pending_settings->exposure = settings.exposure ? settings.exposure : _pending_settings->exposure;
+                }
+
+                PLOG_INFO << fmt::format(
+                    "camera {} ({} [#{}]) capture settings generation {} queued for the next frame (FPS {}, exposure {}ms)",
+                    camera.deviceId,
+                    camera.modelName,
+                    camera.serialNo,
+                    _settings_generation + 1,
+                    _pending_settings->FPS ? fmt::format("{}", *_pending_settings->FPS) : "kept",
+                    _pending_settings->exposure ? fmt::format("{}", *_pending_settings->exposure) : "kept");
+                return _settings_generation + 1;
+            }
+        }
+
+        // no live capture; the pixel clock may change
+        if (settings.FPS)
+        {
+            _set_FPS(*settings.FPS);
+        }
+        if (settings.exposure)
+        {
+            double exposure = *settings.exposure;
+            UEYE_API_CALL(is_Exposure, {handle, IS_EXPOSURE_CMD_SET_EXPOSURE, (void *)&exposure, (UINT)sizeof(exposure)});
+
+            PLOG_INFO << fmt::format(
+                "camera {} ({} [#{}]) requested exposure {}ms; actual {}ms",
+                camera.deviceId,
+                camera.modelName,
+                camera.serialNo,
+                *settings.exposure,
+                exposure);
+        }
+
+        std::lock_guard<std::mutex> lock(_settings_mutex);
+        _settings_effective_frame = 0;
+        return ++_settings_generation;
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::enableFPSGovernor(fpsGovernorPolicy policy)
+    {
+        std::lock_guard<std::mutex> lock(_governor_mutex);
+        _governor.reset();
+        _governor = std::make_unique<fpsGovernor>(
+            policy,
+            [this]()
+            {
+                const double buffers = (double)std::max<int64_t>(_metrics.sequenceBuffers.load(std::memory_order_relaxed), 1);
+                return fpsGovernorSample{
+                    (double)_metrics.lockedBuffers.load(std::memory_order_relaxed) / buffers,
+                    (double)_metrics.queueDepth.load(std::memory_order_relaxed) / buffers,
+                    (uint64_t)(_error_stats.API_IMAGE_LOCKED.count() + _error_stats.DRV_OUT_OF_BUFFERS.count())};
+            },
+            [this](double FPS)
+            { setCaptureSettings({FPS, std::nullopt}); },
+            fmt::format("camera {} ({} [#{}])", camera.deviceId, camera.modelName, camera.serialNo));
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::disableFPSGovernor()
+    {
+        std::lock_guard<std::mutex> lock(_governor_mutex);
+        _governor.reset();
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    std::optional<fpsGovernorState> uEyeHandle<M, D>::governorState() const
+    {
+        std::lock_guard<std::mutex> lock(_governor_mutex);
+        if (!_governor)
+        {
+            return std::nullopt;
+        }
+        return _governor->state();
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::enableBufferScaling(bufferPoolPolicy policy)
+    {
+        const size_t min_buffers = policy.minBuffers ? policy.minBuffers : _concurrency;
+        const size_t max_buffers = policy.budget / _memory_manager.bufferSize();
+        if (max_buffers < min_buffers)
+        {
+            throw std::logic_error(fmt::format("image memory budget of {} bytes holds {} buffers of {} bytes; less than {} minimum",
+                                               policy.budget,
+                                               max_buffers,
+                                               _memory_manager.bufferSize(),
+                                               min_buffers));
+        }
+
+        std::lock_guard<std::mutex> lock(_scaler_mutex);
+        _scaler.reset();
+        _scaler = std::make_unique<bufferPoolScaler>(
+            policy,
+            min_buffers,
+            max_buffers,
+            [this]()
+            {
+                return bufferPoolSample{
+                    _memory_manager.buffers(),
+                    _metrics.lockedBuffers.load(std::memory_order_relaxed),
+                    (uint64_t)(_error_stats.DRV_OUT_OF_BUFFERS.count() + _error_stats.API_NO_DEST_MEM.count()),
+                    _memory_manager.captures() > 0};
+            },
+            [this](size_t buffers)
+            { return _memory_manager.resize(buffers); },
+            fmt::format("camera {} ({} [#{}])", camera.deviceId, camera.modelName, camera.serialNo));
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::disableBufferScaling()
+    {
+        std::lock_guard<std::mutex> lock(_scaler_mutex);
+        _scaler.reset();
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    std::pair<std::optional<captureSettings>, uint64_t> uEyeHandle<M, D>::_settings_for_frame(uint64_t frameNumber, bool live) const
+    {
+        std::lock_guard<std::mutex> lock(_settings_mutex);
+
+        // one change in flight at a time, so frames before the effective one carry the previous generation
+        std::optional<captureSettings> write;
+        if (live && _pending_settings && frameNumber >= _settings_effective_frame)
+        {
+            write = std::exchange(_pending_settings, std::nullopt);
+            _settings_generation++;
+            _settings_effective_frame = frameNumber + 1 + LIVE_SETTINGS_FRAME_DELAY;
+        }
+
+        const bool effective = frameNumber >= _settings_effective_frame || !_settings_generation;
+        return {write, effective ? _settings_generation : _settings_generation - 1};
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    std::unique_lock<std::mutex> uEyeHandle<M, D>::_settings_write_lock() const
+    {
+        return std::unique_lock<std::mutex>(_settings_write_mutex);
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    std::optional<captureSettings> uEyeHandle<M, D>::_live_capture(bool started) const
+    {
+        std::lock_guard<std::mutex> lock(_settings_mutex);
+        if (started)
+        {
+            // frame numbers may restart with the capture
+            if (!_live_captures++)
+            {
+                _settings_effective_frame = 0;
+            }
+            return std::nullopt;
+        }
+
+        if (--_live_captures || !_pending_settings)
+        {
+            return std::nullopt;
+        }
+        _settings_generation++;
+        _settings_effective_frame = 0;
+        return std::exchange(_pending_settings, std::nullopt);
+    }
+
     template <imageColorMode M, imageBitDepth D>
     std::tuple<int, std::string> uEyeHandle<M, D>::_get_last_error_msg() const
     {
@@ -834,6 +1206,9 @@ namespace uEyeWrapper
     template <imageColorMode M, imageBitDepth D>
     uEyeHandle<M, D>::~uEyeHandle()
     {
+        // changes settings and buffers through this handle
+        disableFPSGovernor();
+        disableBufferScaling();
         _stop_threads();
         _cleanup_events();
 
@@ -898,45 +1273,152 @@ namespace uEyeWrapper
 
                 if ((IS_SUCCESS == ret) && (IS_SET_EVENT_CAPTURE_STATUS == wait_events.nSignaled))
                 {
-                    try
-                    {
-                        UEYE_CAPTURE_STATUS_INFO CaptureStatusInfo;
-                        UEYE_API_CALL(is_CaptureStatus, {handle, IS_CAPTURE_STATUS_INFO_CMD_GET, (void *)&CaptureStatusInfo, (UINT)sizeof(CaptureStatusInfo)});
-
-                        _error_stats.update(CaptureStatusInfo, std::chrono::system_clock::now(),
-                                            [this](captureError err)
-                                            {
-                                                PLOG_WARNING << fmt::format(
-                                                    "camera {} ({} [#{}]) {}({}): {}",
-                                                    camera.deviceId,
-                                                    camera.modelName,
-                                                    camera.serialNo,
-                                                    err.name,
-                                                    err.id,
-                                                    err.info);
-                                                
-                                                // call user supplied callback
-                                                if(captureErrorCallback)
-                                                {
-                                                    captureErrorCallback(err);
-                                                }
-                                            });
-                    }
-                    catch (const std::exception &e)
-                    {
-                        PLOG_ERROR << e.what();
-                    }
+                    _handle_capture_status_event();
                 }
             }
             PLOG_DEBUG << fmt::format("camera {} ({} [#{}]) capture status observer shut down", camera.deviceId, camera.modelName, camera.serialNo);
         };
 
         _capture_status_observer_executor = std::thread(observer);
+        _apply_observer_placement();
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::_handle_capture_status_event()
+    {
+        try
+        {
+            UEYE_CAPTURE_STATUS_INFO CaptureStatusInfo;
+            UEYE_API_CALL(is_CaptureStatus, {handle, IS_CAPTURE_STATUS_INFO_CMD_GET, (void *)&CaptureStatusInfo, (UINT)sizeof(CaptureStatusInfo)});
+
+            _error_stats.update(CaptureStatusInfo, std::chrono::system_clock::now(),
+                                [this](const captureError &err)
+                                {
+                                    PLOG_WARNING << fmt::format(
+                                        "camera {} ({} [#{}]) {}({}): {}",
+                                        camera.deviceId,
+                                        camera.modelName,
+                                        camera.serialNo,
+                                        err.name,
+                                        err.id,
+                                        err.info);
+                                    
+                                    // call user supplied callback
+                                    if(captureErrorCallback)
+                                    {
+                                        captureErrorCallback(err);
+                                    }
+                                });
+
+            std::lock_guard<std::mutex> lock(_scaler_mutex);
+            if (_scaler)
+            {
+                _scaler->notify();
+            }
+        }
+        catch (const std::exception &e)
+        {
+            PLOG_ERROR << e.what();
+        }
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::useReactor(eventReactor &reactor)
+    {
+        if (_reactor)
+        {
+            throw std::logic_error("camera already uses an event reactor");
+        }
+
+        // stop the observer thread and reset its terminate signal
+        _stop_threads();
+        UINT terminate_event = IS_SET_EVENT_TERMINATE_HANDLE_THREADS;
+        UEYE_API_CALL(is_Event, {handle, IS_EVENT_CMD_RESET, &terminate_event, (UINT)sizeof(terminate_event)});
+
+        _reactor = &reactor;
+        _reactor_registration = reactor.add(handle, IS_SET_EVENT_CAPTURE_STATUS, [this]()
+                                            { _handle_capture_status_event(); });
+
+        PLOG_INFO << fmt::format("camera {} ({} [#{}]) waiting for events on shared reactor", camera.deviceId, camera.modelName, camera.serialNo);
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::useScheduler(frameScheduler &scheduler, schedulingPolicy policy)
+    {
+        _scheduler = &scheduler;
+        _scheduling_policy = policy;
+
+        PLOG_INFO << fmt::format("camera {} ({} [#{}]) running image callbacks on shared scheduler with {} workers (weight {}, max. concurrency {})",
+                                 camera.deviceId,
+                                 camera.modelName,
+                                 camera.serialNo,
+                                 scheduler.workerCount(),
+                                 policy.weight,
+                                 policy.maxConcurrency);
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::setPixelClockObjective(pixelClockObjective objective)
+    {
+        _pixel_clock_objective = objective;
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::setThreadPlacement(threadPlacement placement)
+    {
+        _thread_placement = placement;
+
+        PLOG_INFO << fmt::format(
+            "camera {} ({} [#{}]) thread placement: dispatcher cpus {} (SCHED_FIFO priority {}), worker cpus {}, observer cpus {}",
+            camera.deviceId,
+            camera.modelName,
+            camera.serialNo,
+            _thread_placement.dispatcherCPUs,
+            _thread_placement.dispatcherPriority,
+            _thread_placement.workerCPUs,
+            _thread_placement.observerCPUs);
+
+        if (_capture_status_observer_executor.joinable())
+        {
+            _apply_observer_placement();
+        }
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    std::string uEyeHandle<M, D>::_thread_name(const std::string &role) const
+    {
+        return fmt::format(
+            "{}-{}",
+            _thread_placement.namePrefix.empty() ? fmt::format("ueye{}", camera.deviceId) : _thread_placement.namePrefix,
+            role);
+    }
+
+    template <imageColorMode M, imageBitDepth D>
+    void uEyeHandle<M, D>::_apply_observer_placement()
+    {
+        auto native_handle = _capture_status_observer_executor.native_handle();
+
+        set_thread_name(native_handle, _thread_name("obs"));
+        if (!set_thread_affinity(native_handle, _thread_placement.observerCPUs))
+        {
+            PLOG_WARNING << fmt::format(
+                "camera {} ({} [#{}]) failed pinning capture status observer to cpus {}",
+                camera.deviceId,
+                camera.modelName,
+                camera.serialNo,
+                _thread_placement.observerCPUs);
+        }
     }
 
     template <imageColorMode M, imageBitDepth D>
     void uEyeHandle<M, D>::_stop_threads()
     {
+        if (_reactor)
+        {
+            _reactor->remove(_reactor_registration);
+            return;
+        }
+
         PLOG_DEBUG << fmt::format("camera {} ({} [#{}]) sending termination signal to background threads", camera.deviceId, camera.modelName, camera.serialNo);
 
         // send event signal IS_SET_EVENT_TERMINATE_HANDLE_THREADS
@@ -1021,36 +1503,57 @@ namespace uEyeWrapper
     template class uEyeHandle<uEye_MONO_16>;
     template class uEyeHandle<uEye_RGB_16>;
 
-    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE> uEyeHandle<uEye_MONO_8>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE>::imageCallbackT);
-    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::LIVE> uEyeHandle<uEye_RGB_8>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::LIVE>::imageCallbackT);
-    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::LIVE> uEyeHandle<uEye_MONO_16>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::LIVE>::imageCallbackT);
-    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::LIVE> uEyeHandle<uEye_RGB_16>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::LIVE>::imageCallbackT);
-    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER> uEyeHandle<uEye_MONO_8>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER>::imageCallbackT);
-    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER> uEyeHandle<uEye_RGB_8>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>::imageCallbackT);
-    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER> uEyeHandle<uEye_MONO_16>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>::imageCallbackT);
-    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER> uEyeHandle<uEye_RGB_16>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>::imageCallbackT);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE> uEyeHandle<uEye_MONO_8>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::LIVE> uEyeHandle<uEye_RGB_8>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::LIVE>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::LIVE>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::LIVE> uEyeHandle<uEye_MONO_16>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::LIVE>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::LIVE>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::LIVE> uEyeHandle<uEye_RGB_16>::getCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::LIVE>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::LIVE>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER> uEyeHandle<uEye_MONO_8>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER> uEyeHandle<uEye_RGB_8>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER> uEyeHandle<uEye_MONO_16>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER> uEyeHandle<uEye_RGB_16>::getCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION> uEyeHandle<uEye_MONO_8>::getCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION> uEyeHandle<uEye_RGB_8>::getCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION> uEyeHandle<uEye_MONO_16>::getCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION> uEyeHandle<uEye_RGB_16>::getCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>::imageCallbackT, std::vector<typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>::subscriberCallbackT>);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE> uEyeHandle<uEye_MONO_8>::getBatchCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::LIVE>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::LIVE> uEyeHandle<uEye_RGB_8>::getBatchCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::LIVE>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::LIVE> uEyeHandle<uEye_MONO_16>::getBatchCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::LIVE>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::LIVE> uEyeHandle<uEye_RGB_16>::getBatchCaptureHandle<captureType::LIVE>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::LIVE>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER> uEyeHandle<uEye_MONO_8>::getBatchCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::TRIGGER>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER> uEyeHandle<uEye_RGB_8>::getBatchCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::TRIGGER>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER> uEyeHandle<uEye_MONO_16>::getBatchCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::TRIGGER>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER> uEyeHandle<uEye_RGB_16>::getBatchCaptureHandle<captureType::TRIGGER>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::TRIGGER>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION> uEyeHandle<uEye_MONO_8>::getBatchCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_8>, captureType::SESSION>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION> uEyeHandle<uEye_RGB_8>::getBatchCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_8>, captureType::SESSION>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION> uEyeHandle<uEye_MONO_16>::getBatchCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_MONO_16>, captureType::SESSION>::batchCallbackT, batchPolicy);
+    template uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION> uEyeHandle<uEye_RGB_16>::getBatchCaptureHandle<captureType::SESSION>(typename uEyeCaptureHandle<uEyeHandle<uEye_RGB_16>, captureType::SESSION>::batchCallbackT, batchPolicy);
 
     // call api methods, log info, throw on error and perform cleanup
     // if message string is zero length, the API will be queried for last error string
     template <typename H>
     UEYE_API_CALL_MEMBER_DEF(imageMemoryManager<H>)
     {
-        auto _msg = msg;
-        const std::string common_prefix = fmt::format(
-            "[{}@{}] memory manager {{camera {} ({} [#{}])}}",
-            caller_name,
-            caller_line,
-            _consumer_handle.camera.deviceId,
-            _consumer_handle.camera.modelName,
-            _consumer_handle.camera.serialNo);
+        // the prefix is only formatted on failure or with debug logging enabled
+        auto common_prefix = [&]()
+        {
+            return fmt::format(
+                "[{}@{}] memory manager {{camera {} ({} [#{}])}}",
+                caller_name,
+                caller_line,
+                _consumer_handle.camera.deviceId,
+                _consumer_handle.camera.modelName,
+                _consumer_handle.camera.serialNo);
+        };
 
         int nret = std::apply(f, f_args);
         if (nret != IS_SUCCESS)
         {
+            std::string _msg(msg);
+
             // query API for error message if user supplied message is empty and return code is IS_NO_SUCCESS
             if (_msg.length() == 0 && nret == IS_NO_SUCCESS)
             {
-                PLOG_DEBUG << fmt::format("{}: querying API for error message", common_prefix);
+                PLOG_DEBUG << fmt::format("{}: querying API for error message", common_prefix());
                 auto err_info = _consumer_handle._get_last_error_msg();
                 _msg = std::get<1>(err_info);
             }
@@ -1063,13 +1566,13 @@ namespace uEyeWrapper
                 nret);
 
             // log the error as warning from wrapper; error handling shall be done by user
-            PLOG_WARNING << fmt::format("{}: {}", common_prefix, common_msg);
+            PLOG_WARNING << fmt::format("{}: {}", common_prefix(), common_msg);
 
             // if a cleanup is required and a handler function is provided, execute it
-            if (cleanup_handler)
+            if constexpr (!std::is_null_pointer_v<std::decay_t<CleanupT>>)
             {
-                PLOG_WARNING << fmt::format("{}: calling provided cleanup handler after failed call to {}()", common_prefix, f_name);
-                cleanup_handler();
+                PLOG_WARNING << fmt::format("{}: calling provided cleanup handler after failed call to {}()", common_prefix(), f_name);
+                _api_cleanup(std::forward<CleanupT>(cleanup_handler));
             }
 
             // throw error
@@ -1077,11 +1580,11 @@ namespace uEyeWrapper
         }
 
         // log API method name and return code for debugging purposes (nret will allways be IS_SUCCESS(0) here)
-        PLOG_DEBUG << fmt::format("{}: {}() returned with code {}", common_prefix, f_name, nret);
+        PLOG_DEBUG << fmt::format("{}: {}() returned with code {}", common_prefix(), f_name, nret);
     }
 
     template <typename H>
-    imageMemoryManager<H>::imageMemoryManager(const H &consumer_handle) : _consumer_handle(consumer_handle) {}
+    imageMemoryManager<H>::imageMemoryManager(const H &consumer_handle) : _consumer_handle(consumer_handle), _captures(0), _triggers_in_flight(0), _last_trigger(0) {}
 
     template <typename H>
     void imageMemoryManager<H>::initialize()
@@ -1100,58 +1603,16 @@ namespace uEyeWrapper
             height,
             bits_per_pixel);
 
-        for (auto _ : times(_consumer_handle._concurrency))
-        {
-            INT memID = 0;
-            char *memPtr = nullptr;
-
-            try
-            {
-                UEYE_API_CALL(is_AllocImageMem, {_consumer_handle.handle, (INT)width, (INT)height, (INT)bits_per_pixel, &memPtr, &memID});
-                PLOG_INFO << fmt::format(
-                    "memory manager {{camera {} ({} [#{}])}} allocated image buffer {}[@{}]",
-                    _consumer_handle.camera.deviceId,
-                    _consumer_handle.camera.modelName,
-                    _consumer_handle.camera.serialNo,
-                    (int)memID,
-                    fmt::ptr(memPtr));
-
-                UEYE_API_CALL(is_AddToSequence, {_consumer_handle.handle, memPtr, memID});
-                PLOG_INFO << fmt::format(
-                    "memory manager {{camera {} ({} [#{}])}} activated image buffer {}[@{}]",
-                    _consumer_handle.camera.deviceId,
-                    _consumer_handle.camera.modelName,
-                    _consumer_handle.camera.serialNo,
-                    (int)memID,
-                    fmt::ptr(memPtr));
-            }
-            catch (...)
-            {
-                PLOG_WARNING << fmt::format(
-                    "memory manager {{camera {} ({} [#{}])}} failed to allocate and activate last image buffer!",
-                    _consumer_handle.camera.deviceId,
-                    _consumer_handle.camera.modelName,
-                    _consumer_handle.camera.serialNo);
-
-                // remove
-                if (memPtr)
-                {
-                    UEYE_API_CALL(is_FreeImageMem, {_consumer_handle.handle, memPtr, memID});
-                }
-            }
-
-            // store buffer in memory map for deactivation and deallocation
-            (*this)[memPtr] = memID;
-        }
+        resize(_consumer_handle._concurrency);
 
         PLOG_INFO << fmt::format(
             "memory manager {{camera {} ({} [#{}])}} allocated {} image buffers",
             _consumer_handle.camera.deviceId,
             _consumer_handle.camera.modelName,
             _consumer_handle.camera.serialNo,
-            size());
+            buffers());
 
-        if (!size())
+        if (!buffers())
         {
             PLOG_ERROR << fmt::format(
                 "memory manager {{camera {} ({} [#{}])}} failed to allocate image buffers",
@@ -1166,6 +1627,7 @@ namespace uEyeWrapper
     template <typename H>
     void imageMemoryManager<H>::cleanup()
     {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
         if (size())
         {
             PLOG_INFO << fmt::format(
@@ -1213,6 +1675,8 @@ namespace uEyeWrapper
                 // remove freed from managed memories
                 it = erase(it);
             }
+            _sequence.clear();
+            _publish();
         }
     }
 
@@ -1222,6 +1686,231 @@ namespace uEyeWrapper
         return at(bufferAddress);
     }
 
+    template <typename H>
+    bool imageMemoryManager<H>::contains(char *bufferAddress) const
+    {
+        return find(bufferAddress) != end();
+    }
+
+    template <typename H>
+    std::shared_lock<std::shared_mutex> imageMemoryManager<H>::share() const
+    {
+        return std::shared_lock<std::shared_mutex>(_mutex);
+    }
+
+    template <typename H>
+    void imageMemoryManager<H>::capturing(bool started) const
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        _captures = started ? _captures + 1 : _captures - 1;
+    }
+
+    template <typename H>
+    size_t imageMemoryManager<H>::captures() const
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return _captures;
+    }
+
+    template <typename H>
+    void imageMemoryManager<H>::triggered() const
+    {
+        _last_trigger.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        _triggers_in_flight.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename H>
+    void imageMemoryManager<H>::frameArrived() const
+    {
+        // frame events of quick triggers may coalesce; the timeout settles the rest
+        size_t in_flight = _triggers_in_flight.load(std::memory_order_relaxed);
+        while (in_flight && !_triggers_in_flight.compare_exchange_weak(in_flight, in_flight - 1, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    template <typename H>
+    size_t imageMemoryManager<H>::resize(size_t buffers)
+    {
+        size_t added = 0;
+        for (size_t n = this->buffers(); n < buffers; n++)
+        {
+            char *memPtr = nullptr;
+            INT memID = 0;
+            try
+            {
+                std::tie(memPtr, memID) = _allocate();
+
+                // the driver fills the buffer once it is in the sequence; dispatchers have to resolve it from then on
+                std::unique_lock<std::shared_mutex> lock(_mutex);
+                UEYE_API_CALL(is_AddToSequence, {_consumer_handle.handle, memPtr, memID});
+                (*this)[memPtr] = memID;
+                _sequence.push_back(memPtr);
+                added++;
+
+                PLOG_INFO << fmt::format(
+                    "memory manager {{camera {} ({} [#{}])}} activated image buffer {}[@{}]",
+                    _consumer_handle.camera.deviceId,
+                    _consumer_handle.camera.modelName,
+                    _consumer_handle.camera.serialNo,
+                    (int)memID,
+                    fmt::ptr(memPtr));
+            }
+            catch (...)
+            {
+                PLOG_WARNING << fmt::format(
+                    "memory manager {{camera {} ({} [#{}])}} failed to allocate and activate last image buffer!",
+                    _consumer_handle.camera.deviceId,
+                    _consumer_handle.camera.modelName,
+                    _consumer_handle.camera.serialNo);
+
+                // remove
+                if (memPtr)
+                {
+                    try
+                    {
+                        UEYE_API_CALL(is_FreeImageMem, {_consumer_handle.handle, memPtr, memID});
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+                break;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        if (added)
+        {
+            if (size() > added)
+            {
+                // not the initial allocation
+                _consumer_handle._metrics.sequenceGrowths.fetch_add(1, std::memory_order_relaxed);
+            }
+            _publish();
+        }
+        if (buffers >= size())
+        {
+            return size();
+        }
+
+        // the driver fills buffers and signals frame events for them while capturing live or for a trigger; triggers, frame
+        // handling and is_LockSeqBuf happen under share(), so neither of them can start until the sequence is rebuilt
+        const auto since_trigger = std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(_last_trigger.load(std::memory_order_relaxed));
+        if (_triggers_in_flight.load(std::memory_order_relaxed) && since_trigger >= IMAGE_MEMORY_TRIGGER_TIMEOUT)
+        {
+            _triggers_in_flight.store(0, std::memory_order_relaxed);
+        }
+        if (_captures || _triggers_in_flight.load(std::memory_order_relaxed) || _consumer_handle._metrics.lockedBuffers.load(std::memory_order_relaxed) > 0)
+        {
+            PLOG_DEBUG << fmt::format(
+                "memory manager {{camera {} ({} [#{}])}} not shrinking sequence while capturing, a triggered frame is in flight or image buffers are locked",
+                _consumer_handle.camera.deviceId,
+                _consumer_handle.camera.modelName,
+                _consumer_handle.camera.serialNo);
+            return size();
+        }
+
+        UEYE_API_CALL(is_ClearSequence, {_consumer_handle.handle});
+
+        std::vector<char *> kept;
+        std::vector<char *> removed(_sequence.begin() + buffers, _sequence.end());
+        for (auto it = _sequence.begin(); it != _sequence.begin() + buffers; it++)
+        {
+            try
+            {
+                UEYE_API_CALL(is_AddToSequence, {_consumer_handle.handle, *it, at(*it)});
+                kept.push_back(*it);
+            }
+            catch (...)
+            {
+                PLOG_WARNING << fmt::format(
+                    "memory manager {{camera {} ({} [#{}])}} failed to reactivate image buffer {}[@{}]",
+                    _consumer_handle.camera.deviceId,
+                    _consumer_handle.camera.modelName,
+                    _consumer_handle.camera.serialNo,
+                    (int)at(*it),
+                    fmt::ptr(*it));
+                removed.push_back(*it);
+            }
+        }
+
+        for (auto memPtr : removed)
+        {
+            const INT memID = at(memPtr);
+            try
+            {
+                UEYE_API_CALL(is_FreeImageMem, {_consumer_handle.handle, memPtr, memID});
+
+                PLOG_INFO << fmt::format(
+                    "memory manager {{camera {} ({} [#{}])}} deallocated image buffer {}[@{}]",
+                    _consumer_handle.camera.deviceId,
+                    _consumer_handle.camera.modelName,
+                    _consumer_handle.camera.serialNo,
+                    (int)memID,
+                    fmt::ptr(memPtr));
+            }
+            catch (...)
+            {
+                PLOG_WARNING << fmt::format(
+                    "memory manager {{camera {} ({} [#{}])}} failed to deallocate image buffer {}[@{}]",
+                    _consumer_handle.camera.deviceId,
+                    _consumer_handle.camera.modelName,
+                    _consumer_handle.camera.serialNo,
+                    (int)memID,
+                    fmt::ptr(memPtr));
+            }
+            erase(memPtr);
+        }
+
+        _sequence = std::move(kept);
+        _consumer_handle._metrics.sequenceShrinks.fetch_add(1, std::memory_order_relaxed);
+        _publish();
+        return size();
+    }
+
+    template <typename H>
+    size_t imageMemoryManager<H>::buffers() const
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        return size();
+    }
+
+    template <typename H>
+    size_t imageMemoryManager<H>::bufferSize() const
+    {
+        auto [width, height] = _consumer_handle._resolution;
+        return ((size_t)width * (size_t)(_consumer_handle._channels * _consumer_handle._bit_depth) + 7) / 8 * (size_t)height;
+    }
+
+    template <typename H>
+    std::pair<char *, INT> imageMemoryManager<H>::_allocate()
+    {
+        auto [width, height] = _consumer_handle._resolution;
+        auto bits_per_pixel = _consumer_handle._channels * _consumer_handle._bit_depth;
+
+        INT memID = 0;
+        char *memPtr = nullptr;
+        UEYE_API_CALL(is_AllocImageMem, {_consumer_handle.handle, (INT)width, (INT)height, (INT)bits_per_pixel, &memPtr, &memID});
+        PLOG_INFO << fmt::format(
+            "memory manager {{camera {} ({} [#{}])}} allocated image buffer {}[@{}]",
+            _consumer_handle.camera.deviceId,
+            _consumer_handle.camera.modelName,
+            _consumer_handle.camera.serialNo,
+            (int)memID,
+            fmt::ptr(memPtr));
+
+        return {memPtr, memID};
+    }
+
+    template <typename H>
+    void imageMemoryManager<H>::_publish()
+    {
+        // requires _mutex
+        _consumer_handle._metrics.sequenceBuffers.store((int64_t)size(), std::memory_order_relaxed);
+        _consumer_handle._metrics.sequenceBytes.store((int64_t)(size() * bufferSize()), std::memory_order_relaxed);
+    }
+
     template <typename H>
     imageMemoryManager<H>::~imageMemoryManager()
     {
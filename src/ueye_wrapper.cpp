@@ -9,24 +9,38 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 #include <fmt/color.h>
+#include <fmt/chrono.h>
 
 #include <plog/Log.h>
 #include <plog/Init.h>
 #include <plog/Formatters/TxtFormatter.h>
-#include <plog/Appenders/ColorConsoleAppender.h>
 #define UEYE_WRAPPER_LOG_LEVEL_DEFAULT warning
 
 #include "wrapper_helpers.h"
 #include "ueye_wrapper.h"
 #include "ip_helpers.h"
+#include "async_log.h"
+
+#include <future>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+using namespace std::chrono_literals;
 
 namespace uEyeWrapper
 {
     // "global" concurrency configuration
     size_t concurrency = 3;
+    // "global" per frame log interval configuration
+    std::chrono::milliseconds frameLogInterval(UEYE_WRAPPER_FRAME_LOG_INTERVAL_MS_DEFAULT);
+    // "global" connection info cache configuration
+    std::chrono::milliseconds connectionInfoTTL(UEYE_WRAPPER_CONNECTION_INFO_TTL_MS_DEFAULT);
+    // "global" camera config cache configuration
+    std::string configCachePath = "";
 
-    static plog::ColorConsoleAppender<plog::TxtFormatter> plogCCA;
-    static auto *logger = plog::get() == nullptr ? &(plog::init(plog::UEYE_WRAPPER_LOG_LEVEL_DEFAULT, &plogCCA)) : plog::get();
+    // log lines are formatted on the calling thread and written to the console by a background thread
+    static asyncLogAppender<plog::TxtFormatter> plogAsync;
+    static auto *logger = plog::get() == nullptr ? &(plog::init(plog::UEYE_WRAPPER_LOG_LEVEL_DEFAULT, &plogAsync)) : plog::get();
 
     plog::Logger<0>& getLogger()
     {
@@ -90,6 +104,55 @@ namespace uEyeWrapper
         throw std::runtime_error("could not determine connection type/info for camera with device id: " + std::to_string(deviceId));
     }
 
+    namespace
+    {
+        // connection info per device id; entries are valid until expiry
+        struct connectionInfoCacheEntry
+        {
+            std::tuple<connectionType, std::string, bool> info;
+            std::chrono::steady_clock::time_point expires;
+        };
+        std::mutex connectionInfoCacheMutex;
+        std::unordered_map<DWORD, connectionInfoCacheEntry> connectionInfoCache;
+
+        // empty when caching is disabled or the entry expired
+        std::optional<std::tuple<connectionType, std::string, bool>> cached_connection_info(DWORD deviceId)
+        {
+            if (connectionInfoTTL.count() <= 0)
+            {
+                return std::nullopt;
+            }
+
+            std::lock_guard<std::mutex> lock(connectionInfoCacheMutex);
+            auto cached = connectionInfoCache.find(deviceId);
+            if (cached == connectionInfoCache.end() || cached->second.expires <= std::chrono::steady_clock::now())
+            {
+                return std::nullopt;
+            }
+            PLOG_DEBUG << fmt::format("using cached connection info for camera with device id {}", deviceId);
+            return cached->second.info;
+        }
+
+        // queries without holding the lock; concurrent queries for distinct devices must not serialize
+        std::tuple<connectionType, std::string, bool> query_connection_info(DWORD deviceId)
+        {
+            const auto ttl = connectionInfoTTL;
+            auto info = getCameraConnectionInfo(deviceId);
+            if (ttl.count() > 0)
+            {
+                std::lock_guard<std::mutex> lock(connectionInfoCacheMutex);
+                connectionInfoCache[deviceId] = {info, std::chrono::steady_clock::now() + ttl};
+            }
+            return info;
+        }
+    }
+
+    void clearConnectionInfoCache()
+    {
+        std::lock_guard<std::mutex> lock(connectionInfoCacheMutex);
+        connectionInfoCache.clear();
+    }
+
     cameraList getCameraList()
     {
         cameraList camList; // = cameraList(0);
@@ -112,9 +175,31 @@ namespace uEyeWrapper
         UEYE_API_CALL(is_GetCameraList, {clPtr}, "failed to get list of cameras", [&]()
                       { delete clPtr; });
 
+        // every camera takes several IP config round trips; query all cameras missing in the cache concurrently
+        std::vector<std::optional<std::tuple<connectionType, std::string, bool>>> cachedInfos(clPtr->dwCount);
+        std::vector<std::future<std::tuple<connectionType, std::string, bool>>> connectionInfos(clPtr->dwCount);
         for (unsigned int i = 0; i < clPtr->dwCount; ++i)
         {
-            const auto connectionInfo = getCameraConnectionInfo(clPtr->uci[i].dwDeviceID);
+            cachedInfos[i] = cached_connection_info(clPtr->uci[i].dwDeviceID);
+            if (!cachedInfos[i])
+            {
+                connectionInfos[i] = std::async(std::launch::async, query_connection_info, clPtr->uci[i].dwDeviceID);
+            }
+        }
+
+        for (unsigned int i = 0; i < clPtr->dwCount; ++i)
+        {
+            std::tuple<connectionType, std::string, bool> connectionInfo;
+            try
+            {
+                connectionInfo = cachedInfos[i] ? *cachedInfos[i] : connectionInfos[i].get();
+            }
+            catch (...)
+            {
+                // remaining futures are joined on destruction
+                delete clPtr;
+                throw;
+            }
             const auto [connection, ipAddress, ipAutoConf] = connectionInfo;
 
             camList.push_back(/*(uEyeCameraInfo)*/ {
@@ -165,4 +250,152 @@ namespace uEyeWrapper
     template uEyeHandle<uEye_MONO_16> openCamera<uEye_MONO_16>(const uEyeCameraInfo, typename uEyeHandle<uEye_MONO_16>::captureErrorCallbackT, std::function<void(uEyeCameraInfo, std::chrono::milliseconds, progress_state &)>);
     template uEyeHandle<uEye_RGB_16> openCamera<uEye_RGB_16>(const uEyeCameraInfo, typename uEyeHandle<uEye_RGB_16>::captureErrorCallbackT, std::function<void(uEyeCameraInfo, std::chrono::milliseconds, progress_state &)>);
 
+    // collects firmware upload progress of concurrently opened cameras; the handler of every uploading camera polls its state
+    class fleetUploadAggregator
+    {
+    public:
+        fleetUploadAggregator(std::function<void(const fleetUploadProgress &)> handler) : _handler(handler){};
+
+        void track(std::chrono::milliseconds estimate, progress_state &state)
+        {
+            size_t index;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                index = _uploads.size();
+                _uploads.push_back({std::chrono::steady_clock::now(), estimate, progress_state::running});
+            }
+
+            while (true)
+            {
+                const auto current = state;
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _uploads[index].state = current;
+                    _report();
+                }
+                if (current != progress_state::running)
+                {
+                    return;
+                }
+                std::this_thread::sleep_for(UEYE_WRAPPER_FLEET_PROGRESS_INTERVAL);
+            }
+        };
+
+    private:
+        struct upload
+        {
+            std::chrono::steady_clock::time_point start;
+            std::chrono::milliseconds estimate;
+            progress_state state;
+        };
+
+        std::function<void(const fleetUploadProgress &)> _handler;
+        std::mutex _mutex;
+        std::vector<upload> _uploads;
+
+        // with _mutex held; serializes handler calls
+        void _report()
+        {
+            const auto now = std::chrono::steady_clock::now();
+            fleetUploadProgress progress = {0, 0, 0, 100.0, 0ms};
+            double done = 0, total = 0;
+            for (const auto &upload : _uploads)
+            {
+                switch (upload.state)
+                {
+                case progress_state::running:
+                {
+                    const auto elapsed = std::min(std::chrono::duration_cast<std::chrono::milliseconds>(now - upload.start), upload.estimate);
+                    progress.uploading++;
+                    progress.remaining = std::max(progress.remaining, upload.estimate - elapsed);
+                    done += elapsed.count();
+                    total += upload.estimate.count();
+                    break;
+                }
+                case progress_state::complete:
+                    progress.completed++;
+                    done += upload.estimate.count();
+                    total += upload.estimate.count();
+                    break;
+                case progress_state::failure:
+                    progress.failed++;
+                    break;
+                }
+            }
+            if (total > 0)
+            {
+                progress.percent = 100.0 * done / total;
+            }
+            _handler(progress);
+        };
+    };
+
+    template <imageColorMode M, imageBitDepth D>
+    std::vector<openResult<M, D>> openCameras(const cameraList &cameras, typename uEyeHandle<M, D>::captureErrorCallbackT captureErrorCallback, size_t parallelism, std::function<void(const fleetUploadProgress &)> uploadProgressHandler)
+    {
+        std::vector<openResult<M, D>> results(cameras.size());
+
+        fleetUploadAggregator uploads(uploadProgressHandler);
+        std::function<void(uEyeCameraInfo, std::chrono::milliseconds, progress_state &)> cameraUploadProgressHandler = nullptr;
+        if (uploadProgressHandler)
+        {
+            cameraUploadProgressHandler = [&uploads](uEyeCameraInfo, std::chrono::milliseconds estimate, progress_state &state)
+            {
+                uploads.track(estimate, state);
+            };
+        }
+
+        // openers take the next camera until all are done; bring-up time approaches the slowest camera for parallelism >= cameras
+        std::atomic<size_t> next(0);
+        auto opener = [&]()
+        {
+            for (size_t i = next++; i < cameras.size(); i = next++)
+            {
+                auto &result = results[i];
+                result.camera = cameras[i];
+
+                const auto start = std::chrono::steady_clock::now();
+                try
+                {
+                    result.handle = std::make_unique<uEyeHandle<M, D>>(cameras[i], captureErrorCallback, cameraUploadProgressHandler);
+                }
+                catch (const std::exception &e)
+                {
+                    result.error = std::current_exception();
+                    PLOG_ERROR << fmt::format("opening camera {} ({} [#{}]) failed: {}", cameras[i].deviceId, cameras[i].modelName, cameras[i].serialNo, e.what());
+                }
+                catch (...)
+                {
+                    result.error = std::current_exception();
+                    PLOG_ERROR << fmt::format("opening camera {} ({} [#{}]) failed", cameras[i].deviceId, cameras[i].modelName, cameras[i].serialNo);
+                }
+                result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            }
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> openers;
+        for (size_t i = 0; i < std::min(std::max(parallelism, (size_t)1), cameras.size()); i++)
+        {
+            openers.emplace_back(opener);
+        }
+        for (auto &thread : openers)
+        {
+            thread.join();
+        }
+
+        PLOG_INFO << fmt::format(
+            "opened {} of {} cameras in {}",
+            std::count_if(results.begin(), results.end(), [](const auto &result)
+                          { return result.handle != nullptr; }),
+            cameras.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+
+        return results;
+    }
+    template std::vector<openResult<uEye_MONO_8>> openCameras<uEye_MONO_8>(const cameraList &, typename uEyeHandle<uEye_MONO_8>::captureErrorCallbackT, size_t, std::function<void(const fleetUploadProgress &)>);
+    template std::vector<openResult<uEye_RGB_8>> openCameras<uEye_RGB_8>(const cameraList &, typename uEyeHandle<uEye_RGB_8>::captureErrorCallbackT, size_t, std::function<void(const fleetUploadProgress &)>);
+    template std::vector<openResult<uEye_MONO_16>> openCameras<uEye_MONO_16>(const cameraList &, typename uEyeHandle<uEye_MONO_16>::captureErrorCallbackT, size_t, std::function<void(const fleetUploadProgress &)>);
+    template std::vector<openResult<uEye_RGB_16>> openCameras<uEye_RGB_16>(const cameraList &, typename uEyeHandle<uEye_RGB_16>::captureErrorCallbackT, size_t, std::function<void(const fleetUploadProgress &)>);
+
 }